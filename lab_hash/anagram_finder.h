@@ -18,6 +18,7 @@
 
 #include "schashtable.h"
 #include "lphashtable.h"
+#include "flathashtable.h"
 #include "textfile.h"
 
 /**
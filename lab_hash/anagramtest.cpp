@@ -51,12 +51,32 @@ int main(int argc, char** argv)
         std::transform(htarg.begin(), htarg.end(), htarg.begin(), tolower);
         if (htarg.find("sc") == 0)
             htarg = "SCHashTable";
+        else if (htarg.find("flat") == 0)
+            htarg = "FlatHashTable";
+        else if (htarg.find("rh") == 0)
+            htarg = "RobinHoodHashTable";
+        else if (htarg.find("pool") == 0)
+            htarg = "PooledSCHashTable";
+        else if (htarg.find("inclp") == 0)
+            htarg = "IncrementalLPHashTable";
+        else if (htarg.find("incsc") == 0)
+            htarg = "IncrementalSCHashTable";
         else
             htarg = "LPHashTable";
         cout << "Checking file " << args[1] << " for anagrams of " << args[2]
              << " using " << htarg << "..." << endl;
         if (htarg == "SCHashTable")
             findAnagrams<SCHashTable>(args[1], args[2]);
+        else if (htarg == "FlatHashTable")
+            findAnagrams<FlatHashTable>(args[1], args[2]);
+        else if (htarg == "RobinHoodHashTable")
+            findAnagrams<RobinHoodHashTable>(args[1], args[2]);
+        else if (htarg == "PooledSCHashTable")
+            findAnagrams<PooledSCHashTable>(args[1], args[2]);
+        else if (htarg == "IncrementalLPHashTable")
+            findAnagrams<IncrementalLPHashTable>(args[1], args[2]);
+        else if (htarg == "IncrementalSCHashTable")
+            findAnagrams<IncrementalSCHashTable>(args[1], args[2]);
         else
             findAnagrams<LPHashTable>(args[1], args[2]);
     }
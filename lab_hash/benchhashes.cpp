@@ -0,0 +1,270 @@
+/**
+ * @file benchhashes.cpp
+ * Benchmark comparing the hash functions in hashes.h, and the tables
+ * that use them, on the words of a text file.
+ *
+ * For each file, prints:
+ *  - the collisions each way of turning a word into an index produces
+ *    over the file's distinct words, against what a truly random
+ *    function would produce, and the longest chain;
+ *  - how fast each hash function hashes the file's words, and long
+ *    strings built from its text;
+ *  - how fast each table counts the file's words, as wordcount does.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "flathashtable.h"
+#include "lphashtable.h"
+#include "schashtable.h"
+#include "textfile.h"
+
+using namespace std;
+
+/**
+ * Number of times each timing is repeated; the fastest run is reported.
+ */
+const int RUNS = 3;
+
+/**
+ * Length of the long strings hashed for the bytes/second figures.
+ */
+const size_t CHUNK = 4096;
+
+/**
+ * Number of distinct words per cell the collision tables are sized for,
+ * about what an LPHashTable keeps.
+ */
+const double LOAD = 0.5;
+
+/**
+ * @return The time since start, in nanoseconds.
+ */
+double nanosSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start)
+        .count();
+}
+
+/**
+ * @return The smallest prime no less than n.
+ */
+size_t primeAtLeast(size_t n)
+{
+    for (;; n++) {
+        bool prime = n >= 2;
+        for (size_t d = 2; prime && d * d <= n; d++)
+            prime = n % d != 0;
+        if (prime)
+            return n;
+    }
+}
+
+/**
+ * Prints one row of the collision table.
+ *
+ * @param scheme How words were turned into indices.
+ * @param indices The index of each distinct word.
+ * @param cells The number of cells indices fall in.
+ */
+void printCollisions(const string& scheme, const vector<size_t>& indices,
+                     size_t cells)
+{
+    vector<size_t> chains(cells, 0);
+    size_t used = 0;
+    size_t longest = 0;
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (chains[indices[i]]++ == 0)
+            used++;
+        longest = max(longest, chains[indices[i]]);
+    }
+    // a random function leaves each cell empty with chance (1 - 1/m)^n
+    double n = indices.size();
+    double m = cells;
+    double expected = n - m * (1 - pow(1 - 1 / m, n));
+
+    cout << left << setw(24) << scheme << right << setw(10) << cells
+         << setw(12) << indices.size() - used << setw(12) << fixed
+         << setprecision(0) << expected << setw(10) << longest << endl;
+}
+
+/**
+ * @return The index of each word under a hasher and multiply-shift.
+ */
+template <class H>
+vector<size_t> reduced(const vector<string>& words, unsigned int bits)
+{
+    H hasher;
+    vector<size_t> indices;
+    for (size_t i = 0; i < words.size(); i++)
+        indices.push_back(hashes::reduce(hasher(words[i]), bits));
+    return indices;
+}
+
+/**
+ * @return The index of each word under a hasher, keeping its low bits.
+ */
+template <class H>
+vector<size_t> masked(const vector<string>& words, unsigned int bits)
+{
+    H hasher;
+    vector<size_t> indices;
+    for (size_t i = 0; i < words.size(); i++)
+        indices.push_back(hasher(words[i]) &
+                          ((static_cast<size_t>(1) << bits) - 1));
+    return indices;
+}
+
+void benchCollisions(const vector<string>& distinct)
+{
+    size_t prime = primeAtLeast(distinct.size() / LOAD);
+    unsigned int bits = 0;
+    while ((static_cast<size_t>(1) << bits) < distinct.size() / LOAD)
+        bits++;
+    size_t pow2 = static_cast<size_t>(1) << bits;
+
+    cout << left << setw(24) << "index" << right << setw(10) << "cells"
+         << setw(12) << "collisions" << setw(12) << "random" << setw(10)
+         << "longest" << endl;
+
+    vector<size_t> indices;
+    for (size_t i = 0; i < distinct.size(); i++)
+        indices.push_back(hashes::hash(distinct[i], prime));
+    printCollisions("hash() % prime", indices, prime);
+    printCollisions("Bernstein & mask", masked<hashes::Bernstein>(distinct, bits), pow2);
+    printCollisions("Bernstein reduce", reduced<hashes::Bernstein>(distinct, bits), pow2);
+    printCollisions("WyHash & mask", masked<hashes::WyHash>(distinct, bits), pow2);
+    printCollisions("WyHash reduce", reduced<hashes::WyHash>(distinct, bits), pow2);
+}
+
+/**
+ * Times hashing every word, and every CHUNK bytes of the text.
+ *
+ * @param name The hash function's name.
+ * @param hasher Hashes a string to a full hash code.
+ */
+template <class F>
+void benchHasher(const string& name, F hasher, const vector<string>& words,
+                 const vector<string>& chunks)
+{
+    volatile uint64_t checksum = 0;
+    double wordNanos = 0;
+    double chunkNanos = 0;
+    for (int run = 0; run < RUNS; run++) {
+        uint64_t sum = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (size_t i = 0; i < words.size(); i++)
+            sum += hasher(words[i]);
+        double nanos = nanosSince(start);
+        if (run == 0 || nanos < wordNanos)
+            wordNanos = nanos;
+
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < chunks.size(); i++)
+            sum += hasher(chunks[i]);
+        nanos = nanosSince(start);
+        if (run == 0 || nanos < chunkNanos)
+            chunkNanos = nanos;
+        checksum = checksum + sum;
+    }
+
+    // a thousand bytes per nanosecond is a megabyte per second
+    cout << left << setw(24) << name << right << setw(12) << fixed
+         << setprecision(2) << wordNanos / words.size() << setw(12)
+         << setprecision(0) << 1000 * chunks.size() * CHUNK / chunkNanos
+         << endl;
+}
+
+struct HashMod
+{
+    size_t operator()(const string& key) const
+    {
+        return hashes::hash(key, 1000003);
+    }
+};
+
+void benchHashers(const vector<string>& words)
+{
+    // long strings made from the text itself
+    string text;
+    for (size_t i = 0; i < words.size(); i++)
+        text += words[i] + " ";
+    vector<string> chunks;
+    for (size_t i = 0; i + CHUNK <= text.size(); i += CHUNK)
+        chunks.push_back(text.substr(i, CHUNK));
+
+    cout << left << setw(24) << "hash function" << right << setw(12)
+         << "ns/word" << setw(12) << "MB/s long" << endl;
+    benchHasher("hash() % prime", HashMod(), words, chunks);
+    benchHasher("Bernstein", hashes::Bernstein(), words, chunks);
+    benchHasher("WyHash", hashes::WyHash(), words, chunks);
+}
+
+/**
+ * Times counting every word in a fresh Dict, as WordFreq does.
+ */
+template <class Dict>
+void benchTable(const string& name, const vector<string>& words)
+{
+    double best = 0;
+    size_t cells = 0;
+    for (int run = 0; run < RUNS; run++) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        Dict dict(256);
+        for (size_t i = 0; i < words.size(); i++)
+            dict[words[i]]++;
+        double nanos = nanosSince(start);
+        if (run == 0 || nanos < best)
+            best = nanos;
+        cells = dict.tableSize();
+    }
+    cout << left << setw(24) << name << right << setw(12) << fixed
+         << setprecision(2) << best / words.size() << setw(12) << cells
+         << endl;
+}
+
+void benchTables(const vector<string>& words)
+{
+    cout << left << setw(24) << "table" << right << setw(12) << "ns/word"
+         << setw(12) << "cells" << endl;
+    benchTable<LPHashTable<string, int>>("LPHashTable", words);
+    benchTable<SCHashTable<string, int>>("SCHashTable", words);
+    benchTable<BernsteinFlatHashTable<string, int>>("BernsteinFlatHashTable", words);
+    benchTable<FlatHashTable<string, int>>("FlatHashTable", words);
+}
+
+int main(int argc, char* argv[])
+{
+    vector<string> files;
+    for (int i = 1; i < argc; i++)
+        files.push_back(argv[i]);
+    if (files.empty()) {
+        files.push_back("SherlockHolmes.txt");
+        files.push_back("metamorphoses.txt");
+    }
+
+    for (size_t f = 0; f < files.size(); f++) {
+        vector<string> words;
+        TextFile infile(files[f]);
+        while (infile.good())
+            words.push_back(infile.getNextWord());
+        set<string> unique(words.begin(), words.end());
+        vector<string> distinct(unique.begin(), unique.end());
+
+        cout << files[f] << ": " << words.size() << " words, "
+             << distinct.size() << " distinct" << endl << endl;
+        benchCollisions(distinct);
+        cout << endl;
+        benchHashers(words);
+        cout << endl;
+        benchTables(words);
+        cout << endl;
+    }
+    return 0;
+}
@@ -42,7 +42,9 @@ void printUsage(const string& progname)
             "be to appear in output"
          << endl;
     cout
-        << "\ttabletype: type of hash table to use (SCHashTable or LPHashTable)"
+        << "\ttabletype: type of hash table to use (SCHashTable, LPHashTable,"
+           " FlatHashTable, RobinHoodHashTable, PooledSCHashTable,"
+           " IncrementalLPHashTable or IncrementalSCHashTable)"
         << endl;
 }
 
@@ -61,12 +63,32 @@ int main(int argc, char** argv)
     std::transform(htarg.begin(), htarg.end(), htarg.begin(), tolower);
     if (htarg.find("sc") == 0)
         htarg = "SCHashTable";
+    else if (htarg.find("flat") == 0)
+        htarg = "FlatHashTable";
+    else if (htarg.find("rh") == 0)
+        htarg = "RobinHoodHashTable";
+    else if (htarg.find("pool") == 0)
+        htarg = "PooledSCHashTable";
+    else if (htarg.find("inclp") == 0)
+        htarg = "IncrementalLPHashTable";
+    else if (htarg.find("incsc") == 0)
+        htarg = "IncrementalSCHashTable";
     else
         htarg = "LPHashTable";
     cout << "Finding chars in " << file << " with frequency >= " << arg
          << " using " << htarg << "..." << endl;
     if (htarg == "SCHashTable")
         countCharacters<SCHashTable>(file, arg);
+    else if (htarg == "FlatHashTable")
+        countCharacters<FlatHashTable>(file, arg);
+    else if (htarg == "RobinHoodHashTable")
+        countCharacters<RobinHoodHashTable>(file, arg);
+    else if (htarg == "PooledSCHashTable")
+        countCharacters<PooledSCHashTable>(file, arg);
+    else if (htarg == "IncrementalLPHashTable")
+        countCharacters<IncrementalLPHashTable>(file, arg);
+    else if (htarg == "IncrementalSCHashTable")
+        countCharacters<IncrementalSCHashTable>(file, arg);
     else
         countCharacters<LPHashTable>(file, arg);
 }
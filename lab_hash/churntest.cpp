@@ -0,0 +1,271 @@
+/**
+ * @file churntest.cpp
+ * Randomized test of the hash tables' insert, remove and find against a
+ * std::map.
+ *
+ * Each table is put through a long random sequence of inserts, updates,
+ * removals (of present and absent keys) and lookups, mirrored in a
+ * std::map. After every removal, the table's contents are compared with
+ * the map and its internal invariants are checked.
+ *
+ * Tables that resize incrementally are also checked after every
+ * operation while a resize is part way through, and once it finishes.
+ * The first time each resize is part way through, the table is copied
+ * and assigned, and the copies are checked too.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "lphashtable.h"
+#include "schashtable.h"
+
+using namespace std;
+
+/**
+ * Number of random operations applied to each table.
+ */
+const int OPERATIONS = 20000;
+
+/**
+ * Number of distinct keys operations choose from. Keys are drawn from a
+ * small pool so that removals and lookups often hit present keys. Half
+ * of all operations insert or update, and a quarter remove, so tables
+ * settle at about two thirds of the keys.
+ */
+const int KEYS = 800;
+
+/**
+ * Minimum number of incremental resizes each incremental table must go
+ * through.
+ */
+const int MIN_RESIZES = 4;
+
+/**
+ * @return The name of the i-th key.
+ */
+string keyName(int i)
+{
+    ostringstream name;
+    name << "key" << i;
+    return name.str();
+}
+
+/**
+ * Checks an LPHashTable's probe distances.
+ */
+bool invariantsHold(const LPHashTable<string, int>& table)
+{
+    return table.probeDistancesValid();
+}
+
+/**
+ * Other tables have no invariants to check beyond their contents.
+ */
+template <class Table>
+bool invariantsHold(const Table&)
+{
+    return true;
+}
+
+/**
+ * Compares a table's contents with the map it mirrors: every key of the
+ * map must be found with its value, and iterating over the table must
+ * visit each of the map's pairs exactly once and nothing else.
+ *
+ * @param table The table to check.
+ * @param expected The pairs it should hold.
+ * @param error Set to a description of the first difference found.
+ * @return Whether the contents match.
+ */
+template <class Table>
+bool contentsMatch(const Table& table, const map<string, int>& expected,
+                   string& error)
+{
+    map<string, int>::const_iterator it;
+    for (it = expected.begin(); it != expected.end(); it++) {
+        if (!table.keyExists(it->first) || table.find(it->first) != it->second) {
+            error = "lost " + it->first;
+            return false;
+        }
+    }
+
+    set<string> seen;
+    typename Table::iterator cell;
+    for (cell = table.begin(); cell != table.end(); cell++) {
+        map<string, int>::const_iterator match = expected.find(cell->first);
+        if (match == expected.end() || match->second != cell->second) {
+            error = "holds stray " + cell->first;
+            return false;
+        }
+        if (!seen.insert(cell->first).second) {
+            error = "holds " + cell->first + " twice";
+            return false;
+        }
+    }
+    if (seen.size() != expected.size()) {
+        error = "is missing pairs when iterated";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Checks a table that is part way through an incremental resize, and
+ * copies of it made by the copy constructor and by assignment.
+ *
+ * @param table The table to check.
+ * @param expected The pairs it should hold.
+ * @param error Set to a description of the first problem found.
+ * @return Whether the table and its copies all match the map.
+ */
+template <class Table>
+bool copiesMatch(const Table& table, const map<string, int>& expected,
+                 string& error)
+{
+    Table copied(table);
+    Table assigned(copied);
+    assigned.remove(expected.begin()->first);
+    assigned = table;
+    if (!contentsMatch(copied, expected, error)) {
+        error = "copy " + error;
+        return false;
+    }
+    if (!contentsMatch(assigned, expected, error)) {
+        error = "assigned copy " + error;
+        return false;
+    }
+    if (!table.resizing() || !contentsMatch(table, expected, error)) {
+        error = "copied table " + error;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Applies OPERATIONS random operations to a table and to a std::map,
+ * comparing the two after every removal, and after every operation
+ * while an incremental resize is under way.
+ *
+ * @param name The table's description, for the report.
+ * @param table The table to test, which starts out empty.
+ * @param seed The seed of the operation sequence.
+ * @param incremental Whether the table resizes incrementally, and so
+ *  must go through at least MIN_RESIZES incremental resizes.
+ * @return Whether the table always matched the map.
+ */
+template <class Table>
+bool churn(const string& name, Table& table, unsigned int seed,
+           bool incremental)
+{
+    map<string, int> expected;
+    string error;
+    int resizes = 0;
+    bool wasResizing = false;
+    srand(seed);
+    for (int op = 0; op < OPERATIONS; op++) {
+        string key = keyName(rand() % KEYS);
+        int choice = rand() % 8;
+        if (choice < 4) {
+            if (expected.count(key) == 0)
+                table.insert(key, op);
+            else
+                table[key] = op;
+            expected[key] = op;
+        } else if (choice < 6) {
+            table.remove(key);
+            expected.erase(key);
+            if (!contentsMatch(table, expected, error)) {
+                cout << name << ": after removal " << op << ", table "
+                     << error << endl;
+                return false;
+            }
+            if (!invariantsHold(table)) {
+                cout << name << ": after removal " << op
+                     << ", probe distances are inconsistent" << endl;
+                return false;
+            }
+        } else {
+            bool present = expected.count(key) != 0;
+            if (table.keyExists(key) != present
+                || table.find(key) != (present ? expected[key] : 0)) {
+                cout << name << ": operation " << op << " looked up the "
+                     << "wrong value for " << key << endl;
+                return false;
+            }
+        }
+
+        // check every key is found exactly once while pairs are split
+        // between the old and new storage, and once they are all moved
+        if (table.resizing() || wasResizing) {
+            if (!contentsMatch(table, expected, error)) {
+                cout << name << ": operation " << op
+                     << (table.resizing() ? " during" : " finishing")
+                     << " a resize left table " << error << endl;
+                return false;
+            }
+            if (!invariantsHold(table)) {
+                cout << name << ": operation " << op << " during a resize"
+                     << " left probe distances inconsistent" << endl;
+                return false;
+            }
+        }
+        if (table.resizing() && !wasResizing) {
+            resizes++;
+            if (!copiesMatch(table, expected, error)) {
+                cout << name << ": operation " << op << " started a resize"
+                     << ", after which the " << error << endl;
+                return false;
+            }
+        }
+        wasResizing = table.resizing();
+    }
+
+    if (incremental && resizes < MIN_RESIZES) {
+        cout << name << ": only went through " << resizes
+             << " incremental resizes" << endl;
+        return false;
+    }
+
+    if (!contentsMatch(table, expected, error)) {
+        cout << name << ": at the end, table " << error << endl;
+        return false;
+    }
+    cout << name << ": matched std::map over " << OPERATIONS
+         << " operations";
+    if (incremental)
+        cout << " and " << resizes << " incremental resizes";
+    cout << endl;
+    return true;
+}
+
+int main()
+{
+    bool passed = true;
+
+    LPHashTable<string, int> linear(17);
+    passed &= churn("LPHashTable", linear, 1, false);
+
+    LPHashTable<string, int> robinHood(17, true);
+    passed &= churn("LPHashTable (robin hood)", robinHood, 2, false);
+
+    LPHashTable<string, int> incremental(17, false, true);
+    passed &= churn("LPHashTable (incremental)", incremental, 3, true);
+
+    LPHashTable<string, int> robinHoodIncremental(17, true, true);
+    passed &= churn("LPHashTable (robin hood, incremental)",
+                    robinHoodIncremental, 4, true);
+
+    SCHashTable<string, int> chained(17, false, true);
+    passed &= churn("SCHashTable (incremental)", chained, 5, true);
+
+    SCHashTable<string, int> pooled(17, true, true);
+    passed &= churn("SCHashTable (pooled, incremental)", pooled, 6, true);
+
+    cout << (passed ? "All churn tests passed" : "Churn tests FAILED") << endl;
+    return passed ? 0 : 1;
+}
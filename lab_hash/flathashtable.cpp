@@ -0,0 +1,265 @@
+/**
+ * @file flathashtable.cpp
+ * Implementation of the BasicFlatHashTable class.
+ */
+#include "flathashtable.h"
+
+#include <cstring>
+#include <new>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using std::pair;
+
+template <class K, class V, class H>
+BasicFlatHashTable<K, V, H>::BasicFlatHashTable(size_t tsize)
+{
+    unsigned int tbits = MIN_BITS;
+    while ((static_cast<size_t>(1) << tbits) < tsize)
+        tbits++;
+    allocate(tbits);
+    elems = 0;
+}
+
+template <class K, class V, class H>
+BasicFlatHashTable<K, V, H>::~BasicFlatHashTable()
+{
+    destroy();
+}
+
+template <class K, class V, class H>
+BasicFlatHashTable<K, V, H> const& BasicFlatHashTable<K, V, H>::
+operator=(BasicFlatHashTable const& rhs)
+{
+    if (this != &rhs) {
+        destroy();
+        copy(rhs);
+    }
+    return *this;
+}
+
+template <class K, class V, class H>
+BasicFlatHashTable<K, V, H>::BasicFlatHashTable(BasicFlatHashTable<K, V, H> const& other)
+{
+    copy(other);
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::allocate(unsigned int tbits)
+{
+    bits = tbits;
+    size_t tsize = static_cast<size_t>(1) << tbits;
+    size = tsize;
+    table = static_cast<pair<K, V>*>(::operator new(tsize * sizeof(pair<K, V>)));
+    ctrl = new signed char[tsize + GROUP_WIDTH - 1];
+    memset(ctrl, EMPTY, tsize + GROUP_WIDTH - 1);
+    tombstones = 0;
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::destroy()
+{
+    for (size_t i = 0; i < size; i++) {
+        if (ctrl[i] >= 0)
+            table[i].~pair();
+    }
+    ::operator delete(table);
+    delete[] ctrl;
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::copy(BasicFlatHashTable<K, V, H> const& other)
+{
+    allocate(other.bits);
+    memcpy(ctrl, other.ctrl, size + GROUP_WIDTH - 1);
+    for (size_t i = 0; i < size; i++) {
+        if (ctrl[i] >= 0)
+            new (&table[i]) pair<K, V>(other.table[i]);
+    }
+    tombstones = other.tombstones;
+    elems = other.elems;
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::setCtrl(size_t idx, signed char c)
+{
+    ctrl[idx] = c;
+    if (idx < GROUP_WIDTH - 1)
+        ctrl[size + idx] = c;
+}
+
+template <class K, class V, class H>
+unsigned int BasicFlatHashTable<K, V, H>::matchGroup(size_t start, signed char c) const
+{
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl + start));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(c)));
+#else
+    unsigned int mask = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; i++) {
+        if (ctrl[start + i] == c)
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+template <class K, class V, class H>
+unsigned int BasicFlatHashTable<K, V, H>::matchFree(size_t start) const
+{
+    // EMPTY and DELETED are the only control bytes below -1
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl + start));
+    return _mm_movemask_epi8(_mm_cmplt_epi8(group, _mm_set1_epi8(-1)));
+#else
+    unsigned int mask = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; i++) {
+        if (ctrl[start + i] < -1)
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+template <class K, class V, class H>
+int BasicFlatHashTable<K, V, H>::findIndex(const K& key) const
+{
+    uint64_t h = hasher(key);
+    signed char t = tag(h);
+    size_t start = homeIndex(h);
+    // if we've probed every cell, the key has not been found
+    for (size_t probed = 0; probed < size; probed += GROUP_WIDTH) {
+        unsigned int matches = matchGroup(start, t);
+        while (matches != 0) {
+            size_t idx = (start + __builtin_ctz(matches)) & (size - 1);
+            if (table[idx].first == key)
+                return idx;
+            matches &= matches - 1;
+        }
+        // the key would have been placed in this group's empty cell
+        if (matchGroup(start, EMPTY) != 0)
+            break;
+        start = (start + GROUP_WIDTH) & (size - 1);
+    }
+    return -1;
+}
+
+template <class K, class V, class H>
+size_t BasicFlatHashTable<K, V, H>::findFree(uint64_t h) const
+{
+    // there is always a free cell, since we grow before the table fills
+    size_t start = homeIndex(h);
+    unsigned int open = matchFree(start);
+    while (open == 0) {
+        start = (start + GROUP_WIDTH) & (size - 1);
+        open = matchFree(start);
+    }
+    return (start + __builtin_ctz(open)) & (size - 1);
+}
+
+template <class K, class V, class H>
+size_t BasicFlatHashTable<K, V, H>::insertNew(K const& key, V const& value)
+{
+    ++elems;
+    if (shouldResize())
+        resizeTable();
+    else if ((elems + tombstones) * 8 >= size * 7)
+        rehash(bits); // mostly tombstones: clear them out at the same size
+
+    uint64_t h = hasher(key);
+    size_t idx = findFree(h);
+    if (ctrl[idx] == DELETED)
+        --tombstones;
+    new (&table[idx]) pair<K, V>(key, value);
+    setCtrl(idx, tag(h));
+    return idx;
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::insert(K const& key, V const& value)
+{
+    int idx = findIndex(key);
+    if (idx != -1)
+        table[idx].second = value;
+    else
+        insertNew(key, value);
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::remove(K const& key)
+{
+    int idx = findIndex(key);
+    if (idx != -1) {
+        table[idx].~pair();
+        setCtrl(idx, DELETED);
+        ++tombstones;
+        --elems;
+    }
+}
+
+template <class K, class V, class H>
+V BasicFlatHashTable<K, V, H>::find(K const& key) const
+{
+    int idx = findIndex(key);
+    if (idx != -1)
+        return table[idx].second;
+    return V();
+}
+
+template <class K, class V, class H>
+V& BasicFlatHashTable<K, V, H>::operator[](K const& key)
+{
+    // First, attempt to find the key and return its value by reference
+    int idx = findIndex(key);
+    if (idx == -1) {
+        // otherwise, insert the default value and return it (insertNew
+        // may reallocate table, so it must run before we index table)
+        idx = insertNew(key, V());
+    }
+    return table[idx].second;
+}
+
+template <class K, class V, class H>
+bool BasicFlatHashTable<K, V, H>::keyExists(K const& key) const
+{
+    return findIndex(key) != -1;
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::clear()
+{
+    destroy();
+    allocate(MIN_BITS);
+    elems = 0;
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::resizeTable()
+{
+    rehash(bits + 1);
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::rehash(unsigned int newBits)
+{
+    pair<K, V>* oldTable = table;
+    signed char* oldCtrl = ctrl;
+    size_t oldSize = size;
+    allocate(newBits);
+
+    for (size_t i = 0; i < oldSize; i++) {
+        if (oldCtrl[i] >= 0) {
+            uint64_t h = hasher(oldTable[i].first);
+            size_t idx = findFree(h);
+            new (&table[idx]) pair<K, V>(std::move(oldTable[i]));
+            setCtrl(idx, tag(h));
+            oldTable[i].~pair();
+        }
+    }
+
+    ::operator delete(oldTable);
+    delete[] oldCtrl;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file flathashtable.h
+ * Definition of a flat, SwissTable-style open addressing Hash Table.
+ */
+#ifndef _FLATHASHTABLE_H_
+#define _FLATHASHTABLE_H_
+
+#include "hashtable.h"
+
+/**
+ * BasicFlatHashTable: a HashTable implementation that uses open
+ * addressing with every key, value pair stored inline in a single array.
+ *
+ * Alongside the pairs is an array of one-byte control bytes, one per
+ * cell. A control byte is either EMPTY, DELETED, or (for an occupied
+ * cell) a 7-bit tag taken from the key's hash. Lookups probe a group of
+ * GROUP_WIDTH control bytes at a time, comparing them all against the
+ * key's tag at once (with SSE2 where available), and only compare the
+ * keys of cells whose tags match. A probe therefore touches the control
+ * bytes and, almost always, only the one pair it is looking for, rather
+ * than following a pointer to every pair it passes over.
+ *
+ * Groups start at any cell and wrap around the end of the table: the
+ * first GROUP_WIDTH - 1 control bytes are mirrored past the end of the
+ * control array so that a group can always be loaded in one read.
+ *
+ * Keys are hashed by the hasher H (see hashes.h), and the table size is
+ * always a power of two, so the full hash code is reduced to a cell by
+ * multiply-shift (hashes::reduce) rather than modulo a prime. The seven
+ * bits after the cell's index in the reduced hash code form the tag.
+ * Use FlatHashTable for the default hasher.
+ */
+template <class K, class V, class H>
+class BasicFlatHashTable : public HashTable<K, V>
+{
+  private:
+    // so we can refer to hash, elems, and size directly, and use the
+    // makeIterator function without having to scope it.
+    using HashTable<K, V>::elems;
+    using HashTable<K, V>::size;
+    using HashTable<K, V>::makeIterator;
+
+    // implementation for our iterator, you don't need to worry about
+    // this
+    class FlatIteratorImpl;
+
+  public:
+    using HashTable<K, V>::shouldResize;
+    // we use HashTable's iterators here
+    typedef typename HashTable<K, V>::iterator iterator;
+
+    /**
+     * Constructs a BasicFlatHashTable of at least the given size.
+     *
+     * @param tsize The desired number of starting cells in the
+     *  BasicFlatHashTable, which is rounded up to a power of two.
+     */
+    BasicFlatHashTable(size_t tsize);
+
+    /**
+     * Destructor for the BasicFlatHashTable. We use dynamic memory, and
+     * thus require the big three.
+     */
+    virtual ~BasicFlatHashTable();
+
+    /**
+     * Assignment operator.
+     *
+     * @param rhs The BasicFlatHashTable we want to assign into the
+     *  current one.
+     * @return A const reference to the current BasicFlatHashTable.
+     */
+    const BasicFlatHashTable<K, V, H>&
+    operator=(const BasicFlatHashTable<K, V, H>& rhs);
+
+    /**
+     * Copy constructor.
+     *
+     * @param other The BasicFlatHashTable to be copied.
+     */
+    BasicFlatHashTable(const BasicFlatHashTable<K, V, H>& other);
+
+    // functions inherited from HashTable
+    virtual void insert(const K& key, const V& value);
+    virtual void remove(const K& key);
+    virtual V find(const K& key) const;
+    virtual bool keyExists(const K& key) const;
+    virtual void clear();
+    virtual V& operator[](const K& key);
+
+    iterator begin() const
+    {
+        return makeIterator(new FlatIteratorImpl(*this, 0));
+    }
+
+    iterator end() const
+    {
+        return makeIterator(new FlatIteratorImpl(*this, size));
+    }
+
+  private:
+    /**
+     * Number of control bytes probed at once.
+     */
+    static const size_t GROUP_WIDTH = 16;
+
+    /**
+     * Control byte of a cell that has never been occupied. Probing stops
+     * at the first group containing one.
+     */
+    static const signed char EMPTY = -128;
+
+    /**
+     * Control byte of a cell whose pair has been removed. Probing
+     * continues past it, but it may be reused by an insert.
+     */
+    static const signed char DELETED = -2;
+
+    /**
+     * Number of bits of each tag.
+     */
+    static const unsigned int TAG_BITS = 7;
+
+    /**
+     * Base 2 logarithm of the smallest table size, which must hold at
+     * least one group.
+     */
+    static const unsigned int MIN_BITS = 4;
+
+    /**
+     * Base 2 logarithm of size.
+     */
+    unsigned int bits;
+
+    /**
+     * Computes the full hash codes of keys.
+     */
+    H hasher;
+
+    /**
+     * Storage for the pairs. Only the cells whose control bytes are
+     * tags hold constructed pairs; the rest are raw memory.
+     */
+    std::pair<K, V>* table;
+
+    /**
+     * Control bytes: size of them, followed by mirrors of the first
+     * GROUP_WIDTH - 1.
+     */
+    signed char* ctrl;
+
+    /**
+     * The number of DELETED cells. They lengthen probes just like
+     * occupied cells, so they count towards the table's occupancy.
+     */
+    size_t tombstones;
+
+    /**
+     * Helper function to determine the index where a given key lies in
+     * the BasicFlatHashTable. If the key does not exist in the table, it
+     * will return -1.
+     *
+     * @param key The key to look for.
+     * @return The index of this key, or -1 if it was not found.
+     */
+    int findIndex(const K& key) const;
+
+    /**
+     * Places a key that is not yet in the table into the first free
+     * cell of its probe sequence, growing the table first if needed.
+     *
+     * @param key The key to be inserted.
+     * @param value The value to be inserted.
+     * @return The index the pair was placed at.
+     */
+    size_t insertNew(const K& key, const V& value);
+
+    /**
+     * Finds the first EMPTY or DELETED cell on the probe sequence of a
+     * key with the given hash.
+     *
+     * @param h The full hash of the key.
+     * @return The index of the free cell.
+     */
+    size_t findFree(uint64_t h) const;
+
+    /**
+     * Sets the control byte of a cell, and its mirror if it has one.
+     *
+     * @param idx The cell to set.
+     * @param c The new control byte.
+     */
+    void setCtrl(size_t idx, signed char c);
+
+    /**
+     * Allocates empty storage for 2^tbits cells, replacing (but not
+     * freeing) the current storage.
+     *
+     * @param tbits The base 2 logarithm of the number of cells.
+     */
+    void allocate(unsigned int tbits);
+
+    /**
+     * Destroys every pair and frees the storage.
+     */
+    void destroy();
+
+    /**
+     * Copies the pairs and control bytes of another table into freshly
+     * allocated storage of the same size.
+     *
+     * @param other The BasicFlatHashTable to copy.
+     */
+    void copy(const BasicFlatHashTable<K, V, H>& other);
+
+    /**
+     * Moves every pair into new storage of the given size, dropping all
+     * tombstones.
+     *
+     * @param newBits The base 2 logarithm of the new storage's size.
+     */
+    void rehash(unsigned int newBits);
+
+    /**
+     * @param h The full hash of a key.
+     * @return The cell the key's probe sequence starts at.
+     */
+    size_t homeIndex(uint64_t h) const
+    {
+        return hashes::reduce(h, bits + TAG_BITS) >> TAG_BITS;
+    }
+
+    /**
+     * @param h The full hash of a key.
+     * @return The 7-bit tag stored in the control byte of its cell.
+     */
+    signed char tag(uint64_t h) const
+    {
+        return hashes::reduce(h, bits + TAG_BITS) & ((1 << TAG_BITS) - 1);
+    }
+
+    /**
+     * Returns a bitmask with bit i set if the control byte of cell
+     * start + i equals c.
+     */
+    unsigned int matchGroup(size_t start, signed char c) const;
+
+    /**
+     * Returns a bitmask with bit i set if cell start + i is EMPTY or
+     * DELETED.
+     */
+    unsigned int matchFree(size_t start) const;
+
+    // inherited from HashTable
+    virtual void resizeTable();
+};
+
+/**
+ * FlatHashTable: a BasicFlatHashTable using the WyHash hasher, for use
+ * wherever a HashTable type taking only a key and value type is expected
+ * (such as the Dict of a WordFreq).
+ */
+template <class K, class V>
+using FlatHashTable = BasicFlatHashTable<K, V, hashes::WyHash>;
+
+/**
+ * BernsteinFlatHashTable: a BasicFlatHashTable using the same hash
+ * function as LPHashTable and SCHashTable, for comparison.
+ */
+template <class K, class V>
+using BernsteinFlatHashTable = BasicFlatHashTable<K, V, hashes::Bernstein>;
+
+#include "flatiterator.h"
+#include "flathashtable.cpp"
+#endif
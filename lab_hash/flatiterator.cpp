@@ -0,0 +1,57 @@
+/** @cond STAFF */
+/**
+ * @file flatiterator.cpp
+ * Implementation of the FlatIteratorImpl implementation class.
+ */
+/** @endcond */
+
+using std::pair;
+
+template <class K, class V, class H>
+BasicFlatHashTable<K, V, H>::FlatIteratorImpl::FlatIteratorImpl(
+    const BasicFlatHashTable<K, V, H>& ht, size_t j)
+    : bucket(j), table(ht)
+{
+    if (bucket < table.size && table.ctrl[bucket] < 0)
+        operator++();
+}
+
+template <class K, class V, class H>
+void BasicFlatHashTable<K, V, H>::FlatIteratorImpl::operator++()
+{
+    // occupied cells are the ones whose control bytes are tags
+    while (++bucket < table.size && table.ctrl[bucket] < 0)
+        ;
+}
+
+template <class K, class V, class H>
+bool BasicFlatHashTable<K, V, H>::FlatIteratorImpl::
+operator==(const HTIteratorImpl& rhs) const
+{
+    const HTIteratorImpl* tmp = &rhs;
+    const FlatIteratorImpl* other = dynamic_cast<const FlatIteratorImpl*>(tmp);
+    if (other == NULL)
+        return false;
+    else
+        return *other == *this;
+}
+
+template <class K, class V, class H>
+bool BasicFlatHashTable<K, V, H>::FlatIteratorImpl::
+operator==(const FlatIteratorImpl& rhs) const
+{
+    return &table == &rhs.table && bucket == rhs.bucket;
+}
+
+template <class K, class V, class H>
+pair<K, V> const& BasicFlatHashTable<K, V, H>::FlatIteratorImpl::operator*()
+{
+    return table.table[bucket];
+}
+
+template <class K, class V, class H>
+typename HashTable<K, V>::HTIteratorImpl*
+BasicFlatHashTable<K, V, H>::FlatIteratorImpl::clone() const
+{
+    return new FlatIteratorImpl(table, bucket);
+}
@@ -0,0 +1,67 @@
+#ifndef _FLATITERATOR_H_
+#define _FLATITERATOR_H_
+/** @cond STAFF */
+
+/**
+ * @file flatiterator.h
+ * Definition of the BasicFlatHashTable iterator implementation.
+ */
+
+/**
+ * FlatIteratorImpl: polymorphic iterator implementation class for
+ * FlatHashTables.
+ */
+template <class K, class V, class H>
+class BasicFlatHashTable<K, V, H>::FlatIteratorImpl
+    : public HashTable<K, V>::HTIteratorImpl
+{
+  public:
+    /**
+     * We friend the BasicFlatHashTable class so that it may construct
+     * iterator implementations with our private constructor.
+     */
+    friend class BasicFlatHashTable<K, V, H>;
+
+    // for simplicity
+    typedef typename HashTable<K, V>::HTIteratorImpl HTIteratorImpl;
+
+    // inherited functions
+    virtual void operator++();
+    virtual bool operator==(const HTIteratorImpl& other) const;
+    virtual const std::pair<K, V>& operator*();
+    virtual HTIteratorImpl* clone() const;
+
+    /**
+     * Equality operator that compares two FlatIteratorImpl. Used by the
+     * generic operator==() for HTIteratorImpl after a successful
+     * dynamic_cast.
+     *
+     * @param other The FlatIteratorImpl to compare against.
+     * @return Whether the two implementations are the same.
+     */
+    virtual bool operator==(const FlatIteratorImpl& other) const;
+
+  private:
+    /**
+     * The current cell we are at in the BasicFlatHashTable's internal
+     * array.
+     */
+    size_t bucket;
+
+    /**
+     * Reference to the BasicFlatHashTable we are iterating over.
+     */
+    const BasicFlatHashTable<K, V, H>& table;
+
+    /**
+     * Private constructor: takes a BasicFlatHashTable to iterate over and a
+     * cell index to start at.
+     *
+     * @param ht The BasicFlatHashTable this iterator is going to be for.
+     * @param i The cell to start at.
+     */
+    FlatIteratorImpl(const BasicFlatHashTable& ht, size_t i);
+};
+/** @endcond */
+#include "flatiterator.cpp"
+#endif
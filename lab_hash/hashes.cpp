@@ -8,6 +8,12 @@
 
 #include "hashes.h"
 
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace hashes
 {
     /**
@@ -32,4 +38,192 @@ namespace hashes
             h = 33 * h + key[i];
         return h % size;
     }
+
+    uint64_t Bernstein::operator()(const char& key) const
+    {
+        return static_cast<unsigned char>(key);
+    }
+
+    uint64_t Bernstein::operator()(const std::string& key) const
+    {
+        unsigned int h = 0;
+        for (size_t i = 0; i < key.length(); ++i)
+            h = 33 * h + key[i];
+        return h;
+    }
+
+    namespace
+    {
+        /**
+         * Constants mixed into the key by WyHash: the first four for
+         * short strings, all sixteen for long strings.
+         */
+        const uint64_t SECRET[16] = {
+            0xe220a8397b1dcdafull, 0x6e789e6aa1b965f4ull, 0x06c45d188009454full,
+            0xf88bb8a8724c81ecull, 0x1b39896a51a8749bull, 0x53cb9f0c747ea2eaull,
+            0x2c829abe1f4532e1ull, 0xc584133ac916ab3cull, 0x3ee5789041c98ac3ull,
+            0xf3b8488c368cb0a6ull, 0x657eecdd3cb13d09ull, 0xc2d326e0055bdef6ull,
+            0x8621a03fe0bbdb7bull, 0x8e1f7555983aa92full, 0xb54e0f1600cc4d19ull,
+            0x84bb3f97971d80abull};
+
+        /**
+         * Bytes per stripe, and stripes between scrambles, of a long
+         * string.
+         */
+        const size_t STRIPE = 64;
+        const size_t STRIPES_PER_BLOCK = 8;
+
+        uint64_t read64(const unsigned char* p)
+        {
+            uint64_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        uint64_t read32(const unsigned char* p)
+        {
+            uint32_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        /**
+         * Multiplies a by b into 128 bits, and folds the product back to
+         * 64 bits by xoring its halves.
+         */
+        uint64_t mix(uint64_t a, uint64_t b)
+        {
+#ifdef __SIZEOF_INT128__
+            __extension__ typedef unsigned __int128 uint128;
+            uint128 r = static_cast<uint128>(a) * b;
+            return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+            uint64_t alo = a & 0xffffffff, ahi = a >> 32;
+            uint64_t blo = b & 0xffffffff, bhi = b >> 32;
+            uint64_t lolo = alo * blo, lohi = alo * bhi;
+            uint64_t hilo = ahi * blo, hihi = ahi * bhi;
+            uint64_t mid = (lolo >> 32) + (lohi & 0xffffffff) + (hilo & 0xffffffff);
+            uint64_t lo = (lolo & 0xffffffff) | (mid << 32);
+            uint64_t hi = hihi + (lohi >> 32) + (hilo >> 32) + (mid >> 32);
+            return lo ^ hi;
+#endif
+        }
+
+        /**
+         * Adds a run of stripes into the accumulators. Each 64-bit lane
+         * of a stripe is xored with the secret, and the product of that
+         * value's two 32-bit halves is added to the lane's accumulator,
+         * along with the neighbouring lane's raw value. Stripe s of the
+         * run uses the secret from byte 8 * s, so reordering stripes
+         * changes the result.
+         */
+        void accumulate(uint64_t* acc, const unsigned char* p, size_t stripes)
+        {
+            const unsigned char* secret
+                = reinterpret_cast<const unsigned char*>(SECRET);
+#ifdef __SSE2__
+            __m128i lanes[4];
+            for (int i = 0; i < 4; i++)
+                lanes[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc) + i);
+            for (size_t s = 0; s < stripes; s++) {
+                const __m128i* data = reinterpret_cast<const __m128i*>(p + s * STRIPE);
+                const __m128i* key = reinterpret_cast<const __m128i*>(secret + 8 * s);
+                for (int i = 0; i < 4; i++) {
+                    __m128i d = _mm_loadu_si128(data + i);
+                    __m128i dk = _mm_xor_si128(d, _mm_loadu_si128(key + i));
+                    // each lane's low half times its high half
+                    __m128i product = _mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+                    __m128i swapped = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+                    lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+                }
+            }
+            for (int i = 0; i < 4; i++)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(acc) + i, lanes[i]);
+#else
+            for (size_t s = 0; s < stripes; s++) {
+                for (size_t j = 0; j < 8; j++) {
+                    uint64_t d = read64(p + s * STRIPE + 8 * j);
+                    uint64_t dk = d ^ read64(secret + 8 * s + 8 * j);
+                    acc[j ^ 1] += d;
+                    acc[j] += (dk & 0xffffffff) * (dk >> 32);
+                }
+            }
+#endif
+        }
+
+        /**
+         * Hashes a string of more than WyHash::LONG_STRING bytes.
+         */
+        uint64_t hashLong(const unsigned char* p, size_t len)
+        {
+            uint64_t acc[8] = {SECRET[8],  SECRET[9],  SECRET[10], SECRET[11],
+                               SECRET[12], SECRET[13], SECRET[14], SECRET[15]};
+            size_t stripes = (len - 1) / STRIPE;
+            size_t done = 0;
+            while (done < stripes) {
+                size_t run = stripes - done;
+                if (run > STRIPES_PER_BLOCK)
+                    run = STRIPES_PER_BLOCK;
+                accumulate(acc, p + done * STRIPE, run);
+                done += run;
+                if (run == STRIPES_PER_BLOCK) {
+                    // scramble, so the high bits of the accumulators
+                    // feed back into their low bits
+                    for (size_t j = 0; j < 8; j++)
+                        acc[j] = (acc[j] ^ (acc[j] >> 47) ^ SECRET[j]) * 0x9e3779b1u;
+                }
+            }
+            // the last (possibly overlapping) stripe
+            accumulate(acc, p + len - STRIPE, 1);
+
+            uint64_t h = len * 0x9e3779b97f4a7c15ull;
+            for (size_t j = 0; j < 8; j += 2)
+                h += mix(acc[j] ^ SECRET[j], acc[j + 1] ^ SECRET[j + 1]);
+            return mix(h ^ SECRET[0], SECRET[1]);
+        }
+    }
+
+    uint64_t WyHash::operator()(const char& key) const
+    {
+        return mix(static_cast<unsigned char>(key) ^ SECRET[0], SECRET[1]);
+    }
+
+    uint64_t WyHash::operator()(const std::string& key) const
+    {
+        return bytes(key.data(), key.length());
+    }
+
+    uint64_t WyHash::bytes(const char* data, size_t len)
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        if (len > LONG_STRING)
+            return hashLong(p, len);
+
+        uint64_t seed = SECRET[0];
+        uint64_t a, b;
+        if (len <= 16) {
+            if (len >= 4) {
+                // two (possibly overlapping) reads from each end
+                size_t mid = (len >> 3) << 2;
+                a = (read32(p) << 32) | read32(p + mid);
+                b = (read32(p + len - 4) << 32) | read32(p + len - 4 - mid);
+            } else if (len > 0) {
+                a = (static_cast<uint64_t>(p[0]) << 16)
+                    | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+                b = 0;
+            } else {
+                a = b = 0;
+            }
+        } else {
+            size_t i = len;
+            while (i > 16) {
+                seed = mix(read64(p) ^ SECRET[1], read64(p + 8) ^ seed);
+                p += 16;
+                i -= 16;
+            }
+            a = read64(p + i - 16);
+            b = read64(p + i - 8);
+        }
+        return mix(SECRET[1] ^ len, mix(a ^ SECRET[1], b ^ seed));
+    }
 }
@@ -9,6 +9,8 @@
 #ifndef _HASH_H_
 #define _HASH_H_
 
+#include <cstddef>
+#include <stdint.h>
 #include <string>
 
 /**
@@ -31,5 +33,67 @@ namespace hashes
      */
     template <class K>
     unsigned int hash(const K& key, int size);
+
+    /**
+     * Bernstein: a hasher computing the same byte-at-a-time hash code as
+     * hash(), but without reducing it modulo a table size.
+     *
+     * Hashers are function objects that compute the full hash code of a
+     * key, leaving tables to reduce it to an index themselves (see
+     * reduce()). A table templated on its hasher (such as
+     * BasicFlatHashTable) can then be given whichever hasher suits its
+     * keys. Every hasher supports char and std::string keys.
+     */
+    struct Bernstein
+    {
+        uint64_t operator()(const char& key) const;
+        uint64_t operator()(const std::string& key) const;
+    };
+
+    /**
+     * WyHash: a hasher that mixes a string eight or sixteen bytes at a
+     * time with 64x64->128 bit multiplies, in the style of wyhash, so
+     * every bit of the key affects every bit of the hash code.
+     *
+     * Strings longer than LONG_STRING bytes are instead consumed 64
+     * bytes at a time into eight independent accumulators, in the style
+     * of XXH3, two accumulators per SSE2 instruction where available
+     * (the result is the same either way).
+     */
+    struct WyHash
+    {
+        uint64_t operator()(const char& key) const;
+        uint64_t operator()(const std::string& key) const;
+
+        /**
+         * Hashes an arbitrary run of bytes.
+         *
+         * @param data The bytes to hash.
+         * @param len The number of bytes.
+         * @return The hash code of the bytes.
+         */
+        static uint64_t bytes(const char* data, size_t len);
+
+        /**
+         * Length above which strings are hashed 64 bytes at a time.
+         */
+        static const size_t LONG_STRING = 128;
+    };
+
+    /**
+     * Reduces a full hash code to an index into a table of 2^bits cells,
+     * by multiply-shift: the top bits of the hash code times a large odd
+     * constant. This is much cheaper than taking the hash code modulo a
+     * prime, and unlike simply masking off the low bits, every bit of
+     * the hash code affects the index.
+     *
+     * @param h The hash code to reduce.
+     * @param bits The base 2 logarithm of the table size, from 1 to 64.
+     * @return An index below 2^bits.
+     */
+    inline size_t reduce(uint64_t h, unsigned int bits)
+    {
+        return static_cast<size_t>((h * 0x9e3779b97f4a7c15ull) >> (64 - bits));
+    }
 }
 #endif
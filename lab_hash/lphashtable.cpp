@@ -8,53 +8,36 @@
  */
 #include "lphashtable.h"
 
+#include <algorithm>
+#include <utility>
+
 using hashes::hash;
 using std::pair;
 
 template <class K, class V>
-LPHashTable<K, V>::LPHashTable(size_t tsize)
+LPHashTable<K, V>::LPHashTable(size_t tsize, bool robinHood,
+                               bool incrementalRehash)
+    : robin_hood(robinHood), incremental(incrementalRehash), old_table(NULL),
+      old_should_probe(NULL), old_distances(NULL), old_size(0), migrated(0)
 {
     if (tsize <= 0)
         tsize = 17;
-    size = findPrime(tsize);
-    table = new pair<K, V>*[size];
-    should_probe = new bool[size];
-    for (size_t i = 0; i < size; i++) {
-        table[i] = NULL;
-        should_probe[i] = false;
-    }
+    allocate(findPrime(tsize));
     elems = 0;
 }
 
 template <class K, class V>
 LPHashTable<K, V>::~LPHashTable()
 {
-    for (size_t i = 0; i < size; i++)
-        delete table[i];
-    delete[] table;
-    delete[] should_probe;
+    destroy();
 }
 
 template <class K, class V>
 LPHashTable<K, V> const& LPHashTable<K, V>::operator=(LPHashTable const& rhs)
 {
     if (this != &rhs) {
-        for (size_t i = 0; i < size; i++)
-            delete table[i];
-        delete[] table;
-        delete[] should_probe;
-
-        table = new pair<K, V>*[rhs.size];
-        should_probe = new bool[rhs.size];
-        for (size_t i = 0; i < rhs.size; i++) {
-            should_probe[i] = rhs.should_probe[i];
-            if (rhs.table[i] == NULL)
-                table[i] = NULL;
-            else
-                table[i] = new pair<K, V>(*(rhs.table[i]));
-        }
-        size = rhs.size;
-        elems = rhs.elems;
+        destroy();
+        copy(rhs);
     }
     return *this;
 }
@@ -62,19 +45,76 @@ LPHashTable<K, V> const& LPHashTable<K, V>::operator=(LPHashTable const& rhs)
 template <class K, class V>
 LPHashTable<K, V>::LPHashTable(LPHashTable<K, V> const& other)
 {
-    table = new pair<K, V>*[other.size];
-    should_probe = new bool[other.size];
+    copy(other);
+}
+
+template <class K, class V>
+void LPHashTable<K, V>::allocate(size_t tsize)
+{
+    size = tsize;
+    table = new pair<K, V>*[size];
+    should_probe = new bool[size];
+    distances = robin_hood ? new size_t[size] : NULL;
+    for (size_t i = 0; i < size; i++) {
+        table[i] = NULL;
+        should_probe[i] = false;
+    }
+}
+
+template <class K, class V>
+void LPHashTable<K, V>::copy(LPHashTable<K, V> const& other)
+{
+    robin_hood = other.robin_hood;
+    incremental = other.incremental;
+    allocate(other.size);
     for (size_t i = 0; i < other.size; i++) {
         should_probe[i] = other.should_probe[i];
-        if (other.table[i] == NULL)
-            table[i] = NULL;
-        else
+        if (other.table[i] != NULL)
             table[i] = new pair<K, V>(*(other.table[i]));
+        if (robin_hood)
+            distances[i] = other.distances[i];
+    }
+    // the copy finishes any migration other is part way through
+    old_table = NULL;
+    old_should_probe = NULL;
+    old_distances = NULL;
+    old_size = 0;
+    migrated = 0;
+    for (size_t i = 0; i < other.old_size; i++) {
+        if (other.old_table[i] != NULL)
+            place(new pair<K, V>(*(other.old_table[i])));
     }
-    size = other.size;
     elems = other.elems;
 }
 
+template <class K, class V>
+void LPHashTable<K, V>::destroy()
+{
+    for (size_t i = 0; i < size; i++)
+        delete table[i];
+    delete[] table;
+    delete[] should_probe;
+    delete[] distances;
+
+    for (size_t i = 0; i < old_size; i++)
+        delete old_table[i];
+    delete[] old_table;
+    delete[] old_should_probe;
+    delete[] old_distances;
+    old_table = NULL;
+    old_should_probe = NULL;
+    old_distances = NULL;
+    old_size = 0;
+}
+
+template <class K, class V>
+bool LPHashTable<K, V>::needsResize() const
+{
+    if (robin_hood)
+        return static_cast<double>(elems) / size >= ROBIN_HOOD_MAX_LOAD;
+    return shouldResize();
+}
+
 template <class K, class V>
 void LPHashTable<K, V>::insert(K const& key, V const& value)
 {
@@ -87,38 +127,117 @@ void LPHashTable<K, V>::insert(K const& key, V const& value)
      */
 
     elems++;
-    if(shouldResize()) {
+    if(needsResize()) {
         resizeTable();
+    } else {
+        migrate(MIGRATE_STEP);
     }
 
-    size_t idx = hash(key, size);
-    size_t start = idx;
+    place(new pair<K, V>(key, value));
+}
+
+template <class K, class V>
+void LPHashTable<K, V>::place(pair<K, V>* entry)
+{
+    if (robin_hood) {
+        placeRobinHood(entry);
+        return;
+    }
+
+    size_t idx = hash(entry->first, size);
     while (table[idx] != NULL)
         idx = (idx + 1) % size;
-    table[idx] = new pair<K, V>(key, value);
+    table[idx] = entry;
     should_probe[idx] = true;
 }
 
 template <class K, class V>
 void LPHashTable<K, V>::remove(K const& key)
 {
+    migrate(MIGRATE_STEP);
     int idx = findIndex(key);
-    if (idx != -1) {
-        delete table[idx];
-        table[idx] = NULL;
-        --elems;
+    if (idx == -1) {
+        // it may not have been migrated yet
+        if (old_table != NULL) {
+            idx = findIndexIn(key, old_table, old_should_probe, old_distances,
+                              old_size);
+            if (idx != -1) {
+                delete old_table[idx];
+                old_table[idx] = NULL;
+                --elems;
+            }
+        }
+        return;
+    }
+    delete table[idx];
+    table[idx] = NULL;
+    --elems;
+
+    if (robin_hood) {
+        // backward-shift deletion: pull each following displaced pair
+        // one cell closer to home, until a pair already at home or an
+        // empty cell, so no gap is left in any probe sequence
+        size_t hole = idx;
+        size_t next = (hole + 1) % size;
+        while (table[next] != NULL && distances[next] > 0) {
+            table[hole] = table[next];
+            distances[hole] = distances[next] - 1;
+            table[next] = NULL;
+            hole = next;
+            next = (next + 1) % size;
+        }
+        should_probe[hole] = false;
     }
 }
 
+template <class K, class V>
+void LPHashTable<K, V>::placeRobinHood(pair<K, V>* entry)
+{
+    size_t idx = hash(entry->first, size);
+    size_t dist = 0;
+    while (table[idx] != NULL) {
+        // take the cell from a pair closer to home than we are, and
+        // carry on placing that pair instead
+        if (distances[idx] < dist) {
+            std::swap(entry, table[idx]);
+            std::swap(dist, distances[idx]);
+        }
+        idx = (idx + 1) % size;
+        dist++;
+    }
+    table[idx] = entry;
+    distances[idx] = dist;
+    should_probe[idx] = true;
+}
+
 template <class K, class V>
 int LPHashTable<K, V>::findIndex(const K& key) const
 {
-    size_t idx = hash(key, size);
+    return findIndexIn(key, table, should_probe, distances, size);
+}
+
+template <class K, class V>
+int LPHashTable<K, V>::findIndexIn(const K& key, pair<K, V>** cells,
+                                   const bool* probe, const size_t* dists,
+                                   size_t tsize) const
+{
+    size_t idx = hash(key, tsize);
+    if (robin_hood) {
+        // the key would have displaced any pair closer to home than it,
+        // so once we pass one, the key is not in the table
+        for (size_t dist = 0; probe[idx] && dists[idx] >= dist; dist++) {
+            if (cells[idx] != NULL && cells[idx]->first == key)
+                return idx;
+            idx = (idx + 1) % tsize;
+        }
+        return -1;
+    }
+
     size_t start = idx;
-    while (should_probe[idx]) {
-        if (table[idx] != NULL && table[idx]->first == key)
+    while (probe[idx]) {
+        if (cells[idx] != NULL && cells[idx]->first == key)
             return idx;
-        idx = (idx + 1) % size;
+        idx = (idx + 1) % tsize;
         // if we've looped all the way around, the key has not been found
         if (idx == start)
             break;
@@ -127,45 +246,85 @@ int LPHashTable<K, V>::findIndex(const K& key) const
 }
 
 template <class K, class V>
-V LPHashTable<K, V>::find(K const& key) const
+pair<K, V>* LPHashTable<K, V>::findEntry(const K& key) const
 {
     int idx = findIndex(key);
     if (idx != -1)
-        return table[idx]->second;
+        return table[idx];
+    if (old_table != NULL) {
+        idx = findIndexIn(key, old_table, old_should_probe, old_distances,
+                          old_size);
+        if (idx != -1)
+            return old_table[idx];
+    }
+    return NULL;
+}
+
+template <class K, class V>
+V LPHashTable<K, V>::find(K const& key) const
+{
+    pair<K, V>* entry = findEntry(key);
+    if (entry != NULL)
+        return entry->second;
     return V();
 }
 
 template <class K, class V>
 V& LPHashTable<K, V>::operator[](K const& key)
 {
+    migrate(MIGRATE_STEP);
     // First, attempt to find the key and return its value by reference
-    int idx = findIndex(key);
-    if (idx == -1) {
+    pair<K, V>* entry = findEntry(key);
+    if (entry == NULL) {
         // otherwise, insert the default value and return it
         insert(key, V());
-        idx = findIndex(key);
+        entry = findEntry(key);
     }
-    return table[idx]->second;
+    return entry->second;
 }
 
 template <class K, class V>
 bool LPHashTable<K, V>::keyExists(K const& key) const
 {
-    return findIndex(key) != -1;
+    return findEntry(key) != NULL;
+}
+
+template <class K, class V>
+bool LPHashTable<K, V>::probeDistancesValid() const
+{
+    if (!robin_hood)
+        return true;
+    for (size_t i = 0; i < size; i++) {
+        if (should_probe[i] != (table[i] != NULL))
+            return false;
+        if (table[i] == NULL)
+            continue;
+        size_t home = hash(table[i]->first, size);
+        if (distances[i] != (i + size - home) % size)
+            return false;
+        size_t prev = (i + size - 1) % size;
+        if (distances[i] > 0
+            && (table[prev] == NULL || distances[prev] + 1 < distances[i]))
+            return false;
+    }
+    // migrated and removed old cells are left empty but still marked for
+    // probing, so only the distances of the pairs left can be checked
+    for (size_t i = 0; i < old_size; i++) {
+        if (old_table[i] == NULL)
+            continue;
+        size_t home = hash(old_table[i]->first, old_size);
+        if (!old_should_probe[i]
+            || old_distances[i] != (i + old_size - home) % old_size)
+            return false;
+    }
+    return true;
 }
 
 template <class K, class V>
 void LPHashTable<K, V>::clear()
 {
-    for (size_t i = 0; i < size; i++)
-        delete table[i];
-    delete[] table;
-    delete[] should_probe;
-    table = new pair<K, V>*[17];
-    should_probe = new bool[17];
-    for (size_t i = 0; i < 17; i++)
-        should_probe[i] = false;
-    size = 17;
+    destroy();
+    allocate(17);
     elems = 0;
 }
 
@@ -173,6 +332,37 @@ template <class K, class V>
 void LPHashTable<K, V>::resizeTable()
 {
     size_t newSize = findPrime(size * 2);
+    if (incremental) {
+        // keep the current storage as the old table, and migrate it a
+        // few cells at a time. Each operation migrates MIGRATE_STEP
+        // cells, so a migration is always finished long before the
+        // new table fills; finish it here just in case.
+        migrate(old_size);
+        old_table = table;
+        old_should_probe = should_probe;
+        old_distances = distances;
+        old_size = size;
+        migrated = 0;
+        allocate(newSize);
+        migrate(MIGRATE_STEP);
+        return;
+    }
+
+    if (robin_hood) {
+        pair<K, V>** oldTable = table;
+        size_t oldSize = size;
+        delete[] should_probe;
+        delete[] distances;
+        allocate(newSize);
+        for (size_t i = 0; i < oldSize; i++) {
+            if (oldTable[i] != NULL)
+                placeRobinHood(oldTable[i]);
+        }
+        // don't delete elements since we just moved their pointers around
+        delete[] oldTable;
+        return;
+    }
+
     pair<K, V> **temp = new pair<K, V> *[newSize];
     delete[] should_probe;
     should_probe = new bool[newSize];
@@ -199,3 +389,29 @@ void LPHashTable<K, V>::resizeTable()
     table = temp;
     size = newSize;
 }
+
+template <class K, class V>
+void LPHashTable<K, V>::migrate(size_t cells)
+{
+    if (old_table == NULL)
+        return;
+    size_t stop = std::min(migrated + cells, old_size);
+    for (; migrated < stop; migrated++) {
+        // moved cells are left NULL but still marked for probing, so
+        // lookups in the old table probe past them
+        if (old_table[migrated] != NULL) {
+            place(old_table[migrated]);
+            old_table[migrated] = NULL;
+        }
+    }
+
+    if (migrated == old_size) {
+        delete[] old_table;
+        delete[] old_should_probe;
+        delete[] old_distances;
+        old_table = NULL;
+        old_should_probe = NULL;
+        old_distances = NULL;
+        old_size = 0;
+    }
+}
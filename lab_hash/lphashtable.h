@@ -44,8 +44,13 @@ class LPHashTable : public HashTable<K, V>
      *
      * @param tsize The desired number of starting cells in the
      *  LPHashTable.
+     * @param robinHood Whether to use Robin Hood probing (see
+     *  robin_hood) instead of plain linear probing.
+     * @param incrementalRehash Whether to resize incrementally (see
+     *  incremental) instead of all at once.
      */
-    LPHashTable(size_t tsize);
+    LPHashTable(size_t tsize, bool robinHood = false,
+                bool incrementalRehash = false);
 
     /**
      * Destructor for the LPHashTable. We use dynamic memory, and thus
@@ -77,6 +82,29 @@ class LPHashTable : public HashTable<K, V>
     virtual void clear();
     virtual V& operator[](const K& key);
 
+    /**
+     * @return Whether an incremental resize is part way through, so that
+     *  some pairs are still in the old storage.
+     */
+    bool resizing() const
+    {
+        return old_table != NULL;
+    }
+
+    /**
+     * Checks the probe distance recorded for every pair, for testing.
+     * With Robin Hood probing, exactly the occupied cells must be
+     * marked for probing, each pair's distance must be how far it lies
+     * past the cell its key hashes to, and no pair may be more than one
+     * cell further from home than the pair before it (so the pair after
+     * an empty cell is at home). Pairs still in the old storage of an
+     * incremental resize must have their distance in the old storage.
+     *
+     * @return Whether the probe distances are consistent; always true
+     *  without Robin Hood probing.
+     */
+    bool probeDistancesValid() const;
+
     iterator begin() const
     {
         return makeIterator(new LPIteratorImpl(*this, 0));
@@ -84,7 +112,7 @@ class LPHashTable : public HashTable<K, V>
 
     iterator end() const
     {
-        return makeIterator(new LPIteratorImpl(*this, size));
+        return makeIterator(new LPIteratorImpl(*this, size + old_size));
     }
 
   private:
@@ -118,10 +146,194 @@ class LPHashTable : public HashTable<K, V>
      */
     int findIndex(const K& key) const;
 
+    /**
+     * Helper function to determine the index where a given key lies in
+     * the given storage, which is either the current storage or the old
+     * storage of an incremental resize.
+     *
+     * @param key The key to look for.
+     * @param cells The storage's pairs.
+     * @param probe The storage's should_probe flags.
+     * @param dists The storage's probe distances, with Robin Hood
+     *  probing.
+     * @param tsize The storage's size.
+     * @return The index of this key, or -1 if it was not found.
+     */
+    int findIndexIn(const K& key, std::pair<K, V>** cells, const bool* probe,
+                    const size_t* dists, size_t tsize) const;
+
+    /**
+     * Helper function to find the pair holding a key in either the
+     * current or the old storage.
+     *
+     * @param key The key to look for.
+     * @return The pair holding key, or NULL if it was not found.
+     */
+    std::pair<K, V>* findEntry(const K& key) const;
+
+    /**
+     * Whether this table uses Robin Hood probing.
+     *
+     * Robin Hood probing is still linear probing, but every cell also
+     * records how far its pair lies from the cell it hashed to (its
+     * probe distance). An insert that meets a pair closer to home than
+     * itself takes that cell and carries on inserting the displaced
+     * pair instead, so probe distances stay short and even. Lookups can
+     * then stop at the first pair closer to home than the key would be,
+     * and removals shift the following pairs back one cell instead of
+     * leaving should_probe set, so removed pairs never lengthen probes.
+     * This keeps lookups fast enough to let the table fill up to
+     * ROBIN_HOOD_MAX_LOAD before resizing.
+     */
+    bool robin_hood;
+
+    /**
+     * Whether this table resizes incrementally.
+     *
+     * A resize normally moves every pair into the new storage at once,
+     * which makes the insert that triggers it take time proportional to
+     * the size of the table. An incremental resize instead keeps the
+     * old storage alongside the new, and every insert, remove and
+     * operator[] moves the next MIGRATE_STEP cells of it across, so no
+     * single operation does more than a bounded amount of rehashing.
+     * Until the old storage is empty, lookups check both, and new pairs
+     * always go into the new storage.
+     */
+    bool incremental;
+
+    std::pair<K, V>** old_table; /**< Old storage, or NULL if no
+                                   incremental resize is under way. */
+    bool* old_should_probe; /**< should_probe of the old storage. */
+    size_t* old_distances; /**< distances of the old storage. */
+    size_t old_size; /**< Size of the old storage, or 0. */
+    size_t migrated; /**< Number of old cells moved so far. */
+
+    /**
+     * Number of old cells moved by each operation during an
+     * incremental resize.
+     */
+    static const size_t MIGRATE_STEP = 8;
+
+    /**
+     * Probe distance of the pair in each cell; only allocated with
+     * Robin Hood probing. With Robin Hood probing, should_probe marks
+     * exactly the occupied cells.
+     */
+    size_t* distances;
+
+    /**
+     * Load factor at which a Robin Hood table resizes.
+     */
+    static constexpr double ROBIN_HOOD_MAX_LOAD = 0.9;
+
+    /**
+     * Determines if the table should resize, for either probing mode.
+     *
+     * @return Whether the table should resize.
+     */
+    bool needsResize() const;
+
+    /**
+     * Helper function to place a pair with Robin Hood probing, starting
+     * from the cell its key hashes to.
+     *
+     * @param entry The pair to place.
+     */
+    void placeRobinHood(std::pair<K, V>* entry);
+
+    /**
+     * Helper function to place a pair in the current storage, for
+     * either probing mode.
+     *
+     * @param entry The pair to place.
+     */
+    void place(std::pair<K, V>* entry);
+
+    /**
+     * Moves up to the given number of cells of the old storage into the
+     * current storage, freeing the old storage once it is all moved.
+     * Does nothing if no incremental resize is under way.
+     *
+     * @param cells The number of old cells to move.
+     */
+    void migrate(size_t cells);
+
+    /**
+     * Iterators visit the current storage's cells followed by the old
+     * storage's.
+     *
+     * @param i The cell to return, below size + old_size.
+     * @return The pair in the cell, or NULL.
+     */
+    std::pair<K, V>* cell(size_t i) const
+    {
+        return i < size ? table[i] : old_table[i - size];
+    }
+
+    /**
+     * Allocates empty storage of the given size, replacing (but not
+     * freeing) the current storage.
+     *
+     * @param tsize The number of cells.
+     */
+    void allocate(size_t tsize);
+
+    /**
+     * Copies the storage and probing mode of another table.
+     *
+     * @param other The LPHashTable to copy.
+     */
+    void copy(const LPHashTable<K, V>& other);
+
+    /**
+     * Frees all pairs and storage.
+     */
+    void destroy();
+
     // inherited from HashTable
     virtual void resizeTable();
 };
 
+/**
+ * RobinHoodHashTable: an LPHashTable that always uses Robin Hood
+ * probing, so that it may be used wherever a HashTable type taking only
+ * a starting size is expected (such as the Dict of a WordFreq).
+ */
+template <class K, class V>
+class RobinHoodHashTable : public LPHashTable<K, V>
+{
+  public:
+    /**
+     * Constructs a RobinHoodHashTable of the given size.
+     *
+     * @param tsize The desired number of starting cells.
+     */
+    RobinHoodHashTable(size_t tsize) : LPHashTable<K, V>(tsize, true)
+    {
+        /* nothing */
+    }
+};
+
+/**
+ * IncrementalLPHashTable: an LPHashTable that always resizes
+ * incrementally, so that it may be used wherever a HashTable type taking
+ * only a starting size is expected (such as the Dict of a WordFreq).
+ */
+template <class K, class V>
+class IncrementalLPHashTable : public LPHashTable<K, V>
+{
+  public:
+    /**
+     * Constructs an IncrementalLPHashTable of the given size.
+     *
+     * @param tsize The desired number of starting cells.
+     */
+    IncrementalLPHashTable(size_t tsize) : LPHashTable<K, V>(tsize, false, true)
+    {
+        /* nothing */
+    }
+};
+
 #include "lpiterator.h"
 #include "lphashtable.cpp"
 #endif
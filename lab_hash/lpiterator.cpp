@@ -15,14 +15,14 @@ LPHashTable<K, V>::LPIteratorImpl::LPIteratorImpl(const LPHashTable<K, V>& ht,
                                                   size_t j)
     : bucket(j), table(ht)
 {
-    if (bucket < table.size && table.table[bucket] == NULL)
+    if (bucket < table.size + table.old_size && table.cell(bucket) == NULL)
         operator++();
 }
 
 template <class K, class V>
 void LPHashTable<K, V>::LPIteratorImpl::operator++()
 {
-    while (++bucket < table.size && table.table[bucket] == NULL)
+    while (++bucket < table.size + table.old_size && table.cell(bucket) == NULL)
         ;
 }
 
@@ -48,7 +48,7 @@ operator==(const LPIteratorImpl& rhs) const
 template <class K, class V>
 pair<K, V> const& LPHashTable<K, V>::LPIteratorImpl::operator*()
 {
-    return *(table.table[bucket]);
+    return *(table.cell(bucket));
 }
 
 template <class K, class V>
@@ -49,7 +49,8 @@ class LPHashTable<K, V>::LPIteratorImpl : public HashTable<K, V>::HTIteratorImpl
   private:
     /**
      * The current bucket we are at in the LPHashTable's internal
-     * array.
+     * array. During an incremental resize, the old array's buckets
+     * follow the current array's.
      */
     size_t bucket;
 
@@ -0,0 +1,59 @@
+/**
+ * @file nodepool.cpp
+ * Implementation of the NodePool class.
+ */
+#include "nodepool.h"
+
+template <class T>
+NodePool<T>::NodePool()
+    : free_list(NULL), next_slot(NULL), slab_end(NULL),
+      next_slab_size(FIRST_SLAB)
+{
+    /* nothing */
+}
+
+template <class T>
+NodePool<T>::~NodePool()
+{
+    clear();
+}
+
+template <class T>
+T* NodePool<T>::allocate()
+{
+    Slot* slot;
+    if (free_list != NULL) {
+        slot = free_list;
+        free_list = slot->next;
+    } else {
+        if (next_slot == slab_end) {
+            next_slot = new Slot[next_slab_size];
+            slab_end = next_slot + next_slab_size;
+            slabs.push_back(next_slot);
+            if (next_slab_size < MAX_SLAB)
+                next_slab_size *= 2;
+        }
+        slot = next_slot++;
+    }
+    return reinterpret_cast<T*>(slot->storage);
+}
+
+template <class T>
+void NodePool<T>::release(T* node)
+{
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->next = free_list;
+    free_list = slot;
+}
+
+template <class T>
+void NodePool<T>::clear()
+{
+    for (size_t i = 0; i < slabs.size(); i++)
+        delete[] slabs[i];
+    slabs.clear();
+    free_list = NULL;
+    next_slot = NULL;
+    slab_end = NULL;
+    next_slab_size = FIRST_SLAB;
+}
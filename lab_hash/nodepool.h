@@ -0,0 +1,91 @@
+/**
+ * @file nodepool.h
+ * Definition of a slab allocator for fixed-size nodes.
+ */
+#ifndef _NODEPOOL_H_
+#define _NODEPOOL_H_
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * NodePool: hands out uninitialised storage for single objects of type
+ * T, carved out of large slabs rather than allocated one at a time.
+ *
+ * Released storage goes onto a free list and is reused by the next
+ * allocation, so a table that inserts and removes at a steady rate
+ * stops calling the system allocator altogether. Slabs double in size
+ * (up to MAX_SLAB objects) as the pool grows, and are only returned to
+ * the system by clear() or the destructor.
+ *
+ * The pool never constructs or destroys a T: callers placement-new into
+ * the storage they are given, and destroy the object before releasing
+ * it.
+ */
+template <class T>
+class NodePool
+{
+  public:
+    /**
+     * Constructs an empty pool. No slabs are allocated until the first
+     * call to allocate().
+     */
+    NodePool();
+
+    /**
+     * Frees every slab. Every object must already have been destroyed.
+     */
+    ~NodePool();
+
+    /**
+     * @return Uninitialised storage suitable for one T.
+     */
+    T* allocate();
+
+    /**
+     * Returns storage to the pool for reuse.
+     *
+     * @param node Storage from allocate(), whose object has already
+     *  been destroyed.
+     */
+    void release(T* node);
+
+    /**
+     * Frees every slab, as if the pool had just been constructed. Every
+     * object must already have been destroyed.
+     */
+    void clear();
+
+  private:
+    // a pool owns its slabs, so it can't be copied
+    NodePool(const NodePool& other) = delete;
+    NodePool& operator=(const NodePool& other) = delete;
+
+    /**
+     * One object's worth of storage, which holds the link to the next
+     * free slot while it is on the free list.
+     */
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    /**
+     * Number of objects in the first slab.
+     */
+    static const size_t FIRST_SLAB = 16;
+
+    /**
+     * Greatest number of objects in one slab.
+     */
+    static const size_t MAX_SLAB = 4096;
+
+    std::vector<Slot*> slabs; /**< Every slab we have allocated. */
+    Slot* free_list; /**< Released slots, most recent first. */
+    Slot* next_slot; /**< Next never-used slot in the newest slab. */
+    Slot* slab_end;  /**< One past the last slot of the newest slab. */
+    size_t next_slab_size; /**< Number of slots in the next slab. */
+};
+
+#include "nodepool.cpp"
+#endif
@@ -9,24 +9,29 @@
 
 #include "schashtable.h"
 
+#include <algorithm>
+#include <new>
+
 using hashes::hash;
 using std::list;
 using std::pair;
 
 template <class K, class V>
-SCHashTable<K, V>::SCHashTable(size_t tsize)
+SCHashTable<K, V>::SCHashTable(size_t tsize, bool pooledNodes,
+                               bool incrementalRehash)
+    : pooled(pooledNodes), incremental(incrementalRehash),
+      old_table(NULL), old_heads(NULL), old_size(0), migrated(0)
 {
     if (tsize <= 0)
         tsize = 17;
-    size = findPrime(tsize);
-    table = new list<pair<K, V>>[size];
+    allocate(findPrime(tsize));
     elems = 0;
 }
 
 template <class K, class V>
 SCHashTable<K, V>::~SCHashTable()
 {
-    delete[] table;
+    destroy();
 }
 
 template <class K, class V>
@@ -34,12 +39,8 @@ SCHashTable<K, V> const& SCHashTable<K, V>::
 operator=(SCHashTable<K, V> const& rhs)
 {
     if (this != &rhs) {
-        delete[] table;
-        table = new list<pair<K, V>>[rhs.size];
-        for (size_t i = 0; i < rhs.size; i++)
-            table[i] = rhs.table[i];
-        size = rhs.size;
-        elems = rhs.elems;
+        destroy();
+        copy(rhs);
     }
     return *this;
 }
@@ -47,19 +48,155 @@ operator=(SCHashTable<K, V> const& rhs)
 template <class K, class V>
 SCHashTable<K, V>::SCHashTable(SCHashTable<K, V> const& other)
 {
-    table = new list<pair<K, V>>[other.size];
-    for (size_t i = 0; i < other.size; i++)
-        table[i] = other.table[i];
-    size = other.size;
+    copy(other);
+}
+
+template <class K, class V>
+void SCHashTable<K, V>::allocate(size_t tsize)
+{
+    size = tsize;
+    if (pooled) {
+        table = NULL;
+        heads = new Node*[size]();
+    } else {
+        table = new list<pair<K, V>>[size];
+        heads = NULL;
+    }
+}
+
+template <class K, class V>
+void SCHashTable<K, V>::copy(SCHashTable<K, V> const& other)
+{
+    pooled = other.pooled;
+    incremental = other.incremental;
+    allocate(other.size);
+    if (pooled) {
+        for (size_t i = 0; i < size; i++) {
+            // copy each chain in order, appending through a tail link
+            Node** tail = &heads[i];
+            for (Node* n = other.heads[i]; n != NULL; n = n->next) {
+                *tail = new (pool.allocate())
+                    Node(n->entry.first, n->entry.second, NULL);
+                tail = &(*tail)->next;
+            }
+        }
+    } else {
+        for (size_t i = 0; i < size; i++)
+            table[i] = other.table[i];
+    }
+
+    // the copy finishes any migration other is part way through
+    old_table = NULL;
+    old_heads = NULL;
+    old_size = 0;
+    migrated = 0;
+    for (size_t i = 0; i < other.old_size; i++) {
+        if (pooled) {
+            for (Node* n = other.old_heads[i]; n != NULL; n = n->next) {
+                size_t idx = hash(n->entry.first, size);
+                heads[idx] = new (pool.allocate())
+                    Node(n->entry.first, n->entry.second, heads[idx]);
+            }
+        } else {
+            typename list<pair<K, V>>::iterator it;
+            for (it = other.old_table[i].begin(); it != other.old_table[i].end(); it++)
+                table[hash(it->first, size)].push_front(*it);
+        }
+    }
     elems = other.elems;
 }
 
+template <class K, class V>
+void SCHashTable<K, V>::destroy()
+{
+    if (pooled) {
+        for (size_t i = 0; i < size + old_size; i++) {
+            for (Node* n = bucketHead(i); n != NULL;) {
+                Node* next = n->next;
+                n->~Node();
+                n = next;
+            }
+        }
+        pool.clear();
+    }
+    delete[] table;
+    delete[] heads;
+    delete[] old_table;
+    delete[] old_heads;
+    old_table = NULL;
+    old_heads = NULL;
+    old_size = 0;
+}
+
+template <class K, class V>
+typename SCHashTable<K, V>::Node* SCHashTable<K, V>::findNode(K const& key) const
+{
+    for (Node* n = heads[hash(key, size)]; n != NULL; n = n->next) {
+        if (n->entry.first == key)
+            return n;
+    }
+    // it may not have been migrated yet
+    if (old_heads != NULL) {
+        for (Node* n = old_heads[hash(key, old_size)]; n != NULL; n = n->next) {
+            if (n->entry.first == key)
+                return n;
+        }
+    }
+    return NULL;
+}
+
+template <class K, class V>
+pair<K, V>* SCHashTable<K, V>::findEntry(K const& key) const
+{
+    if (pooled) {
+        Node* n = findNode(key);
+        return n == NULL ? NULL : &n->entry;
+    }
+
+    size_t idx = hash(key, size);
+    typename list<pair<K, V>>::iterator it;
+    for (it = table[idx].begin(); it != table[idx].end(); it++) {
+        if (it->first == key)
+            return &*it;
+    }
+    // it may not have been migrated yet
+    if (old_table != NULL) {
+        idx = hash(key, old_size);
+        for (it = old_table[idx].begin(); it != old_table[idx].end(); it++) {
+            if (it->first == key)
+                return &*it;
+        }
+    }
+    return NULL;
+}
+
+template <class K, class V>
+typename SCHashTable<K, V>::Node*
+SCHashTable<K, V>::insertNode(K const& key, V const& value)
+{
+    ++elems;
+    if (shouldResize())
+        resizeTable();
+    else
+        migrate(MIGRATE_STEP);
+    size_t idx = hash(key, size);
+    heads[idx] = new (pool.allocate()) Node(key, value, heads[idx]);
+    return heads[idx];
+}
+
 template <class K, class V>
 void SCHashTable<K, V>::insert(K const& key, V const& value)
 {
+    if (pooled) {
+        insertNode(key, value);
+        return;
+    }
+
     ++elems;
     if (shouldResize())
         resizeTable();
+    else
+        migrate(MIGRATE_STEP);
     pair<K, V> p(key, value);
     size_t idx = hash(key, size);
     table[idx].push_front(p);
@@ -68,7 +205,6 @@ void SCHashTable<K, V>::insert(K const& key, V const& value)
 template <class K, class V>
 void SCHashTable<K, V>::remove(K const& key)
 {
-    typename list<pair<K, V>>::iterator it;
     /**
      * @todo Implement this function.
      *
@@ -76,40 +212,73 @@ void SCHashTable<K, V>::remove(K const& key)
      * erase() function on std::list!
      */
 
-    size_t idx = hash(key, size);
-    for(it = table[idx].begin(); it != table[idx].end(); it++) {
-        if (it->first == key)
-            table[idx].erase(it);
+    migrate(MIGRATE_STEP);
+    if (pooled) {
+        if (!unlinkNode(heads[hash(key, size)], key) && old_heads != NULL)
+            unlinkNode(old_heads[hash(key, old_size)], key);
+        return;
     }
+
+    if (!eraseFromList(table[hash(key, size)], key) && old_table != NULL)
+        eraseFromList(old_table[hash(key, old_size)], key);
 }
 
 template <class K, class V>
-V SCHashTable<K, V>::find(K const& key) const
+bool SCHashTable<K, V>::unlinkNode(Node*& chain, K const& key)
+{
+    // unlink through the link that points at the node
+    for (Node** link = &chain; *link != NULL; link = &(*link)->next) {
+        if ((*link)->entry.first == key) {
+            Node* n = *link;
+            *link = n->next;
+            n->~Node();
+            pool.release(n);
+            --elems;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class K, class V>
+bool SCHashTable<K, V>::eraseFromList(list<pair<K, V>>& bucket, K const& key)
 {
-    size_t idx = hash(key, size);
     typename list<pair<K, V>>::iterator it;
-    for (it = table[idx].begin(); it != table[idx].end(); it++) {
-        if (it->first == key)
-            return it->second;
+    for(it = bucket.begin(); it != bucket.end(); it++) {
+        if (it->first == key) {
+            bucket.erase(it);
+            --elems;
+            return true;
+        }
     }
+    return false;
+}
+
+template <class K, class V>
+V SCHashTable<K, V>::find(K const& key) const
+{
+    pair<K, V>* entry = findEntry(key);
+    if (entry != NULL)
+        return entry->second;
     return V();
 }
 
 template <class K, class V>
 V& SCHashTable<K, V>::operator[](K const& key)
 {
-    size_t idx = hash(key, size);
-    typename list<pair<K, V>>::iterator it;
-    for (it = table[idx].begin(); it != table[idx].end(); it++) {
-        if (it->first == key)
-            return it->second;
-    }
+    migrate(MIGRATE_STEP);
+    pair<K, V>* entry = findEntry(key);
+    if (entry != NULL)
+        return entry->second;
+
+    if (pooled)
+        return insertNode(key, V())->entry.second;
 
     ++elems;
     if (shouldResize())
         resizeTable();
 
-    idx = hash(key, size);
+    size_t idx = hash(key, size);
     pair<K, V> p(key, V());
     table[idx].push_front(p);
     return table[idx].front().second;
@@ -118,21 +287,14 @@ V& SCHashTable<K, V>::operator[](K const& key)
 template <class K, class V>
 bool SCHashTable<K, V>::keyExists(K const& key) const
 {
-    size_t idx = hash(key, size);
-    typename list<pair<K, V>>::iterator it;
-    for (it = table[idx].begin(); it != table[idx].end(); it++) {
-        if (it->first == key)
-            return true;
-    }
-    return false;
+    return findEntry(key) != NULL;
 }
 
 template <class K, class V>
 void SCHashTable<K, V>::clear()
 {
-    delete[] table;
-    table = new list<pair<K, V>>[17];
-    size = 17;
+    destroy();
+    allocate(17);
     elems = 0;
 }
 
@@ -143,8 +305,34 @@ void SCHashTable<K, V>::resizeTable()
 
     size_t newSize = findPrime(size * 2);
 
+    if (incremental) {
+        // keep the current buckets as the old buckets, and migrate them
+        // a few at a time. Each operation migrates MIGRATE_STEP buckets,
+        // so a migration is always finished long before the new buckets
+        // fill; finish it here just in case.
+        migrate(old_size);
+        old_table = table;
+        old_heads = heads;
+        old_size = size;
+        migrated = 0;
+        allocate(newSize);
+        migrate(MIGRATE_STEP);
+        return;
+    }
+
+    if (pooled) {
+        // relink every node into its new bucket; no pair is copied
+        Node** oldHeads = heads;
+        size_t oldSize = size;
+        allocate(newSize);
+        for (size_t i = 0; i < oldSize; i++)
+            relink(oldHeads[i]);
+        delete[] oldHeads;
+        return;
+    }
+
     std::list<std::pair<K, V>>* newTable = new std::list<pair<K, V>>[newSize];
-    
+
     for(size_t i=0; i < size; i++) {
         for(it = table[i].begin(); it != table[i].end(); it++) {
             size_t idx = hash(it->first, newSize);
@@ -155,3 +343,43 @@ void SCHashTable<K, V>::resizeTable()
     size = newSize;
     table = newTable;
 }
+
+template <class K, class V>
+void SCHashTable<K, V>::relink(Node*& chain)
+{
+    while (chain != NULL) {
+        Node* n = chain;
+        chain = n->next;
+        size_t idx = hash(n->entry.first, size);
+        n->next = heads[idx];
+        heads[idx] = n;
+    }
+}
+
+template <class K, class V>
+void SCHashTable<K, V>::migrate(size_t buckets)
+{
+    if (old_size == 0)
+        return;
+    size_t stop = std::min(migrated + buckets, old_size);
+    for (; migrated < stop; migrated++) {
+        // move the nodes themselves, so references to values stay valid
+        if (pooled) {
+            relink(old_heads[migrated]);
+        } else {
+            list<pair<K, V>>& bucket = old_table[migrated];
+            while (!bucket.empty()) {
+                size_t idx = hash(bucket.front().first, size);
+                table[idx].splice(table[idx].begin(), bucket, bucket.begin());
+            }
+        }
+    }
+
+    if (migrated == old_size) {
+        delete[] old_table;
+        delete[] old_heads;
+        old_table = NULL;
+        old_heads = NULL;
+        old_size = 0;
+    }
+}
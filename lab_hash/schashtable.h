@@ -10,6 +10,7 @@
 #define _SCHASHTABLE_H_
 
 #include "hashtable.h"
+#include "nodepool.h"
 #include <list>
 
 /**
@@ -45,8 +46,13 @@ class SCHashTable : public HashTable<K, V>
      *
      * @param tsize The desired number of starting cells in the
      *    SCHashTable.
+     * @param pooledNodes Whether to chain pooled nodes (see pooled)
+     *    instead of std::lists.
+     * @param incrementalRehash Whether to resize incrementally (see
+     *    incremental) instead of all at once.
      */
-    SCHashTable(size_t tsize);
+    SCHashTable(size_t tsize, bool pooledNodes = false,
+                bool incrementalRehash = false);
 
     /**
      * Destructor for the SCHashTable. We use dynamic memory, and thus
@@ -78,6 +84,15 @@ class SCHashTable : public HashTable<K, V>
     virtual void clear();
     virtual V& operator[](const K& key);
 
+    /**
+     * @return Whether an incremental resize is part way through, so that
+     *    some pairs are still in the old buckets.
+     */
+    bool resizing() const
+    {
+        return old_size != 0;
+    }
+
     iterator begin() const
     {
         return makeIterator(new SCIteratorImpl(*this, 0, false));
@@ -85,7 +100,7 @@ class SCHashTable : public HashTable<K, V>
 
     iterator end() const
     {
-        return makeIterator(new SCIteratorImpl(*this, size, true));
+        return makeIterator(new SCIteratorImpl(*this, size + old_size, true));
     }
 
   private:
@@ -98,9 +113,217 @@ class SCHashTable : public HashTable<K, V>
      */
     std::list<std::pair<K, V>>* table;
 
+    /**
+     * A link in a singly-linked chain of pairs, used when pooled.
+     */
+    struct Node {
+        std::pair<K, V> entry; /**< The key, value pair. */
+        Node* next; /**< The next node in the chain, or NULL. */
+
+        Node(const K& key, const V& value, Node* nxt)
+            : entry(key, value), next(nxt)
+        {
+            /* nothing */
+        }
+    };
+
+    /**
+     * Whether this table chains pooled nodes.
+     *
+     * A std::list allocates every node on its own with the system
+     * allocator, and each node carries two links. Pooled chains are
+     * singly-linked Nodes whose storage comes from a NodePool owned by
+     * this table, so inserts rarely allocate, nodes sit together in
+     * memory, and each costs one link. Resizing relinks the existing
+     * nodes into the new buckets rather than copying their pairs.
+     *
+     * When pooled, heads holds the chains and table is NULL; otherwise
+     * heads is NULL.
+     */
+    bool pooled;
+
+    /**
+     * First node of each bucket's chain, when pooled.
+     */
+    Node** heads;
+
+    /**
+     * Storage for the Nodes, when pooled.
+     */
+    NodePool<Node> pool;
+
+    /**
+     * Helper function to find the node holding a key, when pooled.
+     *
+     * @param key The key to look for.
+     * @return The node holding key, or NULL if it was not found.
+     */
+    Node* findNode(const K& key) const;
+
+    /**
+     * Helper function to find the pair holding a key, in either
+     * chaining mode and in either the current or the old buckets.
+     *
+     * @param key The key to look for.
+     * @return The pair holding key, or NULL if it was not found.
+     */
+    std::pair<K, V>* findEntry(const K& key) const;
+
+    /**
+     * Helper function to remove a key's node from a chain, when pooled.
+     *
+     * @param chain The head of the chain.
+     * @param key The key to be removed.
+     * @return Whether the key was found.
+     */
+    bool unlinkNode(Node*& chain, const K& key);
+
+    /**
+     * Helper function to remove a key's pair from a bucket's list.
+     *
+     * @param bucket The bucket's list.
+     * @param key The key to be removed.
+     * @return Whether the key was found.
+     */
+    bool eraseFromList(std::list<std::pair<K, V>>& bucket, const K& key);
+
+    /**
+     * Helper function to move every node of a chain to the front of its
+     * bucket in heads, when pooled. Leaves the chain empty.
+     *
+     * @param chain The head of the chain.
+     */
+    void relink(Node*& chain);
+
+    /**
+     * Whether this table resizes incrementally.
+     *
+     * A resize normally moves every pair into the new buckets at once,
+     * which makes the insert that triggers it take time proportional to
+     * the size of the table. An incremental resize instead keeps the
+     * old buckets alongside the new, and every insert, remove and
+     * operator[] moves the next MIGRATE_STEP old buckets across, so no
+     * single operation does more than a bounded amount of rehashing.
+     * Until the old buckets are empty, lookups check both, and new pairs
+     * always go into the new buckets. Migrating splices list nodes (or
+     * relinks pooled nodes), so no pair is copied or moved in memory.
+     */
+    bool incremental;
+
+    std::list<std::pair<K, V>>* old_table; /**< Old lists, or NULL. */
+    Node** old_heads; /**< Old chains, or NULL. */
+    size_t old_size; /**< Number of old buckets, or 0 if no incremental
+                       resize is under way. */
+    size_t migrated; /**< Number of old buckets moved so far. */
+
+    /**
+     * Number of old buckets moved by each operation during an
+     * incremental resize.
+     */
+    static const size_t MIGRATE_STEP = 8;
+
+    /**
+     * Moves up to the given number of old buckets into the current
+     * buckets, freeing the old buckets once they are all moved. Does
+     * nothing if no incremental resize is under way.
+     *
+     * @param buckets The number of old buckets to move.
+     */
+    void migrate(size_t buckets);
+
+    /**
+     * Iterators visit the current buckets followed by the old ones.
+     *
+     * @param i The bucket to return, below size + old_size.
+     * @return The bucket's list, when not pooled.
+     */
+    std::list<std::pair<K, V>>& bucketList(size_t i) const
+    {
+        return i < size ? table[i] : old_table[i - size];
+    }
+
+    /**
+     * @param i The bucket to return, below size + old_size.
+     * @return The head of the bucket's chain, when pooled.
+     */
+    Node* bucketHead(size_t i) const
+    {
+        return i < size ? heads[i] : old_heads[i - size];
+    }
+
+    /**
+     * Helper function to add a node to the front of a key's chain, when
+     * pooled. Resizes first if needed, just like insert().
+     *
+     * @param key The key to be inserted.
+     * @param value The value to be inserted.
+     * @return The new node.
+     */
+    Node* insertNode(const K& key, const V& value);
+
+    /**
+     * Allocates empty storage of the given size, replacing (but not
+     * freeing) the current storage.
+     *
+     * @param tsize The number of buckets.
+     */
+    void allocate(size_t tsize);
+
+    /**
+     * Copies the storage and chaining mode of another table.
+     *
+     * @param other The SCHashTable to copy.
+     */
+    void copy(const SCHashTable<K, V>& other);
+
+    /**
+     * Frees all pairs and storage.
+     */
+    void destroy();
+
     // inherited from HashTable
     virtual void resizeTable();
 };
+/**
+ * PooledSCHashTable: an SCHashTable that always chains pooled nodes, so
+ * that it may be used wherever a HashTable type taking only a starting
+ * size is expected (such as the Dict of a WordFreq).
+ */
+template <class K, class V>
+class PooledSCHashTable : public SCHashTable<K, V>
+{
+  public:
+    /**
+     * Constructs a PooledSCHashTable of the given size.
+     *
+     * @param tsize The desired number of starting buckets.
+     */
+    PooledSCHashTable(size_t tsize) : SCHashTable<K, V>(tsize, true)
+    {
+        /* nothing */
+    }
+};
+
+/**
+ * IncrementalSCHashTable: an SCHashTable that always resizes
+ * incrementally, so that it may be used wherever a HashTable type taking
+ * only a starting size is expected (such as the Dict of a WordFreq).
+ */
+template <class K, class V>
+class IncrementalSCHashTable : public SCHashTable<K, V>
+{
+  public:
+    /**
+     * Constructs an IncrementalSCHashTable of the given size.
+     *
+     * @param tsize The desired number of starting buckets.
+     */
+    IncrementalSCHashTable(size_t tsize) : SCHashTable<K, V>(tsize, false, true)
+    {
+        /* nothing */
+    }
+};
+
 #include "sciterator.h"
 #include "schashtable.cpp"
 #endif
@@ -14,11 +14,19 @@ using std::list;
 template <class K, class V>
 SCHashTable<K, V>::SCIteratorImpl::SCIteratorImpl(const SCHashTable<K, V>& ht,
                                                   size_t i, bool en)
-    : table(ht), bucket(i), end(en)
+    : table(ht), bucket(i), node(NULL), end(en)
 {
-    if (bucket < table.size) {
-        bucket_iterator = table.table[bucket].begin();
-        if (bucket_iterator == table.table[bucket].end())
+    if (table.pooled) {
+        // find the first non-empty chain at or after bucket
+        while (bucket < table.size + table.old_size && table.bucketHead(bucket) == NULL)
+            ++bucket;
+        if (bucket < table.size + table.old_size)
+            node = table.bucketHead(bucket);
+        else
+            end = true;
+    } else if (bucket < table.size + table.old_size) {
+        bucket_iterator = table.bucketList(bucket).begin();
+        if (bucket_iterator == table.bucketList(bucket).end())
             operator++();
     }
 }
@@ -26,11 +34,24 @@ SCHashTable<K, V>::SCIteratorImpl::SCIteratorImpl(const SCHashTable<K, V>& ht,
 template <class K, class V>
 void SCHashTable<K, V>::SCIteratorImpl::operator++()
 {
-    if (++bucket_iterator == table.table[bucket].end()) {
-        while (++bucket < table.size && table.table[bucket].empty())
+    if (table.pooled) {
+        node = node->next;
+        if (node == NULL) {
+            while (++bucket < table.size + table.old_size && table.bucketHead(bucket) == NULL)
+                ;
+            if (bucket < table.size + table.old_size)
+                node = table.bucketHead(bucket);
+            else
+                end = true;
+        }
+        return;
+    }
+
+    if (++bucket_iterator == table.bucketList(bucket).end()) {
+        while (++bucket < table.size + table.old_size && table.bucketList(bucket).empty())
             ;
-        if (bucket < table.size) {
-            bucket_iterator = table.table[bucket].begin();
+        if (bucket < table.size + table.old_size) {
+            bucket_iterator = table.bucketList(bucket).begin();
         } else
             end = true;
     }
@@ -52,6 +73,9 @@ template <class K, class V>
 bool SCHashTable<K, V>::SCIteratorImpl::
 operator==(const SCIteratorImpl& rhs) const
 {
+    if (table.pooled)
+        return &table == &rhs.table && bucket == rhs.bucket
+               && node == rhs.node;
     return &table == &rhs.table && bucket == rhs.bucket
            && (bucket_iterator == rhs.bucket_iterator || (end && rhs.end));
 }
@@ -59,6 +83,8 @@ operator==(const SCIteratorImpl& rhs) const
 template <class K, class V>
 const pair<K, V>& SCHashTable<K, V>::SCIteratorImpl::operator*()
 {
+    if (table.pooled)
+        return node->entry;
     return *bucket_iterator;
 }
 
@@ -66,5 +92,10 @@ template <class K, class V>
 typename HashTable<K, V>::HTIteratorImpl*
 SCHashTable<K, V>::SCIteratorImpl::clone() const
 {
-    return new SCIteratorImpl(table, bucket, end);
+    // the constructor starts at the front of the bucket, so carry over
+    // our position within it
+    SCIteratorImpl* other = new SCIteratorImpl(table, bucket, end);
+    other->bucket_iterator = bucket_iterator;
+    other->node = node;
+    return other;
 }
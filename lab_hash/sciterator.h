@@ -62,6 +62,12 @@ class SCHashTable<K, V>::SCIteratorImpl : public HashTable<K, V>::HTIteratorImpl
      */
     typename std::list<std::pair<K, V>>::iterator bucket_iterator;
 
+    /**
+     * Current node in the bucket we are visiting, when the table is
+     * pooled. NULL at the end of the table.
+     */
+    Node* node;
+
     /**
      * Hacky way of keeping track that we are at the end of the table.
      */
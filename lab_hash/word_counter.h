@@ -11,6 +11,7 @@
 
 #include "schashtable.h"
 #include "lphashtable.h"
+#include "flathashtable.h"
 #include "textfile.h"
 
 #include <vector>
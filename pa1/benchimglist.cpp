@@ -0,0 +1,234 @@
+// File:        benchimglist.cpp
+// Date:        2026-10-19
+// Description: Benchmark harness for the ImgList class
+//              Times construction, carving, rendering, copying and destruction
+//              over the PA1 input images and larger synthetic images
+//              Every phase runs REPEATS times on fresh lists; the fastest run is reported
+
+#include "imglist.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+
+using namespace std;
+using namespace cs221util;
+
+#define REPEATS 5
+
+// allocation counters, maintained by the global operator new replacements below
+static size_t allocations = 0;
+static size_t allocatedbytes = 0;
+
+void* operator new(size_t size) {
+  allocations++;
+  allocatedbytes += size;
+  void* p = malloc(size == 0 ? 1 : size);
+  if (!p) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+// kept out of line: once inlined at -O2, g++ mistakes the free for a mismatched delete
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  operator delete(p);
+}
+
+// measurements taken for a single benchmark phase
+struct PhaseResult {
+  double nanoseconds;
+  size_t allocs;
+  size_t bytes;
+};
+
+// bench function definitions
+void BenchImage(const string& name, PNG& img);
+PNG MakeSyntheticImage(unsigned int width, unsigned int height);
+void KeepFastest(PhaseResult& best, const PhaseResult& run, int repeat);
+void PrintPhase(const string& phase, const PhaseResult& result, double pixels);
+long PeakRSSKilobytes();
+
+// helper class that measures time and allocations between its construction and Stop()
+class PhaseTimer {
+  public:
+    PhaseTimer() {
+      startallocs = allocations;
+      startbytes = allocatedbytes;
+      start = chrono::steady_clock::now();
+    }
+
+    PhaseResult Stop() {
+      chrono::steady_clock::time_point end = chrono::steady_clock::now();
+      PhaseResult result;
+      result.nanoseconds = chrono::duration<double, nano>(end - start).count();
+      result.allocs = allocations - startallocs;
+      result.bytes = allocatedbytes - startbytes;
+      return result;
+    }
+
+  private:
+    chrono::steady_clock::time_point start;
+    size_t startallocs;
+    size_t startbytes;
+};
+
+int main(int argc, char* argv[]) {
+  // optional argument: largest synthetic image side length
+  unsigned int maxside = 512;
+  if (argc > 1) {
+    maxside = atoi(argv[1]);
+  }
+
+  cout << left << setw(28) << "image/phase" << right
+       << setw(14) << "ns/pixel" << setw(14) << "allocs" << setw(16) << "bytes" << endl;
+
+  const char* inputs[] = { "3x4.png", "5x6.png", "6x6grad.png" };
+  for (unsigned int i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+    PNG img;
+    if (img.readFromFile(string("input-images/") + inputs[i])) {
+      BenchImage(inputs[i], img);
+    }
+  }
+
+  for (unsigned int side = 64; side <= maxside; side *= 2) {
+    PNG img = MakeSyntheticImage(side, side);
+    stringstream name;
+    name << "synthetic " << side << "x" << side;
+    BenchImage(name.str(), img);
+  }
+
+  cout << "Peak RSS: " << PeakRSSKilobytes() << " KB" << endl;
+  return 0;
+}
+
+/*
+* Runs every benchmark phase on img and prints one line per phase.
+* Each carving mode carves a quarter of the image width from a fresh list.
+*/
+void BenchImage(const string& name, PNG& img) {
+  double pixels = (double) img.width() * img.height();
+  unsigned int rounds = img.width() / 4;
+  cout << name << endl;
+
+  PhaseResult construct, copy, destroy;
+  for (int r = 0; r < REPEATS; r++) {
+    PhaseTimer constructtimer;
+    ImgList* list = new ImgList(img);
+    KeepFastest(construct, constructtimer.Stop(), r);
+
+    PhaseTimer copytimer;
+    ImgList* listcopy = new ImgList(*list);
+    KeepFastest(copy, copytimer.Stop(), r);
+
+    PhaseTimer destroytimer;
+    delete listcopy;
+    delete list;
+    KeepFastest(destroy, destroytimer.Stop(), r);
+  }
+  PrintPhase("construct", construct, pixels);
+  PrintPhase("copy", copy, pixels);
+
+  for (int mode = 0; mode <= 1; mode++) {
+    PhaseResult carve, render, fill[3];
+    for (int r = 0; r < REPEATS; r++) {
+      ImgList carvelist(img);
+      PhaseTimer carvetimer;
+      carvelist.Carve(rounds, mode);
+      KeepFastest(carve, carvetimer.Stop(), r);
+
+      if (mode == 1) {
+        PhaseTimer rendertimer;
+        PNG out = carvelist.Render(false, 0);
+        KeepFastest(render, rendertimer.Stop(), r);
+
+        for (int fillmode = 0; fillmode <= 2; fillmode++) {
+          PhaseTimer filltimer;
+          PNG filled = carvelist.Render(true, fillmode);
+          KeepFastest(fill[fillmode], filltimer.Stop(), r);
+        }
+      }
+    }
+
+    stringstream phase;
+    phase << "carve mode " << mode << " (" << rounds << ")";
+    PrintPhase(phase.str(), carve, pixels);
+    if (mode == 1) {
+      PrintPhase("render nogaps", render, pixels);
+      for (int fillmode = 0; fillmode <= 2; fillmode++) {
+        stringstream fillphase;
+        fillphase << "render fillmode " << fillmode;
+        PrintPhase(fillphase.str(), fill[fillmode], pixels);
+      }
+    }
+  }
+
+  PrintPhase("destroy (x2)", destroy, pixels);
+}
+
+/*
+* Builds a deterministic test image of the given size: a hue gradient across
+* the image with pseudo-random luminance noise, so that both selection modes
+* have non-trivial choices to make.
+*/
+PNG MakeSyntheticImage(unsigned int width, unsigned int height) {
+  PNG img(width, height);
+  unsigned int seed = 221;
+  for (unsigned int y = 0; y < height; y++) {
+    for (unsigned int x = 0; x < width; x++) {
+      seed = seed * 1103515245 + 12345;
+      HSLAPixel* pixel = img.getPixel(x, y);
+      pixel->h = 360.0 * x / width;
+      pixel->s = 0.5 + 0.5 * y / height;
+      pixel->l = ((seed >> 16) % 1000) / 1000.0;
+      pixel->a = 1.0;
+    }
+  }
+  return img;
+}
+
+/*
+* Records run into best if it is the first or the fastest run of a phase so far.
+* Allocation counts are the same on every run, so only the time is compared.
+*/
+void KeepFastest(PhaseResult& best, const PhaseResult& run, int repeat) {
+  if (repeat == 0 || run.nanoseconds < best.nanoseconds) {
+    best = run;
+  }
+}
+
+void PrintPhase(const string& phase, const PhaseResult& result, double pixels) {
+  cout << "  " << left << setw(26) << phase << right << fixed << setprecision(2)
+       << setw(14) << result.nanoseconds / pixels
+       << setw(14) << result.allocs << setw(16) << result.bytes << endl;
+}
+
+/*
+* Returns the peak resident set size of this process, in kilobytes.
+*/
+long PeakRSSKilobytes() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
@@ -10,6 +10,7 @@
 #include "imglist.h"
 
 #include <math.h> // provides fmax, fmin, and fabs functions
+#include <unordered_map>
 
 /**************************
 * MISCELLANEOUS FUNCTIONS *
@@ -31,6 +32,84 @@ double HueDiff(double hue1, double hue2) {
   return fmin(fabs(hue1 - hue2), fabs(360 + fmin(hue1, hue2) - fmax(hue1, hue2)));
 }
 
+/*
+* This function is NOT part of the ImgList class.
+* Returns the value of a carving selection criterion for the pixel curr,
+* whose neighbours along the seam's axis are prev and next.
+* PRE: selectionmode is an integer in the range [0,1]
+* PARAM: selectionmode - see the documentation for the ImgList::SelectNode function.
+*        0: luminance of curr
+*        1: total of the hue differences between curr and each of its neighbours
+*/
+double CarveCost(const HSLAPixel& prev, const HSLAPixel& curr, const HSLAPixel& next, int selectionmode) {
+  if (selectionmode == 0) {
+    return curr.l;
+  }
+  return HueDiff(prev.h, curr.h) + HueDiff(next.h, curr.h);
+}
+
+/*
+* This function is NOT part of the ImgList class.
+* Sets pixel to the colour Render gives to the i-th pixel of a gap of "gap" pixels
+* that lies between the pixels before and after it.
+* PRE: fillmode is an integer in the range [0,2]
+* PRE: i is in the range [1, gap]
+* PARAM: fillmode - see the documentation for the ImgList::Render function.
+*/
+void SetGapColour(HSLAPixel* pixel, const HSLAPixel& before, const HSLAPixel& after, unsigned int i, unsigned int gap, int fillmode) {
+  switch (fillmode) {
+    case 1: { // average of neighbours
+      double hueDiff = HueDiff(before.h, after.h);
+      double newH = fmin((int) (before.h + hueDiff / 2) % 360, (int) (after.h + hueDiff / 2) % 360);
+      double newS = (before.s + after.s) / 2.0;
+      double newL = (before.l + after.l) / 2.0;
+      double newA = (before.a + after.a) / 2.0;
+      *pixel = HSLAPixel(newH, newS, newL, newA);
+      break;
+    }
+    case 2: { // gradient
+      double DELTA = 0.0000000001;
+      double totalHueDiff = HueDiff(before.h, after.h);
+      if (before.h + totalHueDiff > 360 && (before.h + totalHueDiff - 360 - after.h) < DELTA) {
+        totalHueDiff = -totalHueDiff;
+      }
+      if (before.h + totalHueDiff != after.h) {
+        totalHueDiff = -totalHueDiff;
+      }
+
+      double hDiff = totalHueDiff * i / (gap+1);
+      double sDiff = before.s - after.s;
+      double lDiff = before.l - after.l;
+      double aDiff = before.a - after.a;
+      double newH = (int) (before.h + hDiff) % 360;
+      double newS = (before.s - sDiff * i / (gap+1));
+      double newL = (before.l - lDiff * i / (gap+1));
+      double newA = (before.a - aDiff * i / (gap+1));
+      *pixel = HSLAPixel(newH, newS, newL, newA);
+      break;
+    }
+    default: // copy colour of the pixel before the gap
+      *pixel = before;
+  }
+}
+
+/*
+* This function is NOT part of the ImgList class.
+* Fills the pixels of column x strictly between rows top and bottom that are
+* not yet filled, as a gap between the colours above and below, for Render.
+* PARAM: filled - whether each pixel of out has been drawn, row by row; updated
+* PARAM: fillmode - see the documentation for the ImgList::Render function.
+*/
+void FillColumnGap(PNG& out, vector<bool>& filled, unsigned int x, unsigned int top, const HSLAPixel& above,
+                   unsigned int bottom, const HSLAPixel& below, int fillmode) {
+  for (unsigned int y = top + 1; y < bottom; y++) {
+    if (!filled[y * out.width() + x]) {
+      SetGapColour(out.getPixel(x, y), above, below, y - top, bottom - top - 1, fillmode);
+      filled[y * out.width() + x] = true;
+    }
+  }
+}
+
 /*********************
 * CONSTRUCTORS, ETC. *
 *********************/
@@ -42,6 +121,7 @@ ImgList::ImgList() {
   // set appropriate values for all member attributes here
     northwest = NULL;
     southeast = NULL;
+    ResetMetadata(0, 0);
 }
 
 /*
@@ -49,6 +129,7 @@ ImgList::ImgList() {
 * PRE: img has dimensions of at least 1x1
 */
 ImgList::ImgList(PNG& img) {
+  ResetMetadata(img.width(), img.height());
   vector<ImgNode*> aboveRow = vector<ImgNode*>(img.width(), NULL);
   for (unsigned y = 0; y < img.height(); y++) {
     ImgNode *left = NULL;
@@ -62,6 +143,12 @@ ImgList::ImgList(PNG& img) {
       node->west = left;
 
       // Set special nodes
+      if (x == 0) {
+        rowstarts[y] = node;
+      }
+      if (y == 0) {
+        colstarts[x] = node;
+      }
       if (y == 0 && x == 0) {
         northwest = node;
       }
@@ -126,54 +213,66 @@ ImgList::~ImgList() {
 
 /*
 * Returns the horizontal dimension of this list (counted in nodes)
-* Note that every row will contain the same number of nodes, whether or not
-*   the list has been carved.
-* We expect your solution to take linear time in the number of nodes in the
-*   x dimension.
+* Note that every row will contain the same number of nodes while only Carve
+*   has been used. Once CarveVertical has also removed nodes, rows may differ
+*   (see GetRowWidth), and this is the width of the top row, which CarveVertical
+*   never shortens.
+* Runs in constant time; the value is maintained by the constructors, Carve and Uncarve.
 */
 unsigned int ImgList::GetDimensionX() const {
-  ImgNode *node = northwest;
-  int dim = 0;
-  while(node) {
-    dim++;
-    node = node->east;
-  }
-  return dim;
+  return dimx;
 }
 
 /*
 * Returns the vertical dimension of the list (counted in nodes)
-* It is useful to know/assume that the grid will never have nodes removed
-*   from the first or last columns. The returned value will thus correspond
-*   to the height of the PNG image from which this list was constructed.
-* We expect your solution to take linear time in the number of nodes in the
-*   y dimension.
+* This is the height of the first column, which Carve never shortens. It
+*   corresponds to the height of the PNG image from which this list was
+*   constructed, less one for each CarveVertical round still in effect.
+* Runs in constant time; the value is maintained by the constructors,
+*   CarveVertical and Uncarve.
 */
 unsigned int ImgList::GetDimensionY() const {
-  ImgNode *node = northwest;
-  int dim = 0;
-  while(node) {
-    dim++;
-    node = node->south;
-  }
-  return dim;
+  return dimy;
 }
 
 /*
 * Returns the horizontal dimension of the list (counted in original pixels, pre-carving)
 * The returned value will thus correspond to the width of the PNG image from
 *   which this list was constructed.
-* We expect your solution to take linear time in the number of nodes in the
-*   x dimension.
+* Runs in constant time; carving never changes this value.
 */
 unsigned int ImgList::GetDimensionFullX() const {
-  ImgNode *node = northwest;
-  int dim = 0;
-  while(node) {
-    dim += 1 + node->skipright;
-    node = node->east;
+  return dimfullx;
+}
+
+/*
+* Returns the number of live nodes in the given row of the original image, counting from the top.
+* PARAM: row - index of the row, in the range [0, height of the original image)
+* RETURN: the number of nodes in that row, or 0 if the row does not exist
+*/
+unsigned int ImgList::GetRowWidth(unsigned int row) const {
+  if (row >= rowwidths.size()) {
+    return 0;
   }
-  return dim;
+  return rowwidths[row];
+}
+
+/*
+* Returns the number of carving rounds that have removed nodes from this list,
+* whether they were made by Carve, CarveVertical or Retarget.
+* Rounds requested beyond the width - 2 or height - 2 limits are not counted,
+* and rounds undone by Uncarve are no longer counted.
+*/
+unsigned int ImgList::GetCarveCount() const {
+  return carvehistory.size();
+}
+
+/*
+* Returns the selection mode used by each carving round (see GetCarveCount)
+* applied to this list, in the order the rounds were performed.
+*/
+const vector<int>& ImgList::GetCarveHistory() const {
+  return carvehistory;
 }
 
 /*
@@ -224,8 +323,16 @@ ImgNode* ImgList::SelectNode(ImgNode* rowstart, int selectionmode) {
 * PRE: fillmode is an integer in the range of [0,2]
 * PARAM: fillgaps - whether or not to fill gaps caused by carving
 *          false: render one pixel per node, ignores fillmode
-*          true: render the full width of the original image,
+*                 Each node moves left past the gaps Carve made to its west in its row,
+*                 and up past the gaps CarveVertical made to its north in its column.
+*                 Once both have been used, rows and columns have lost different numbers
+*                 of nodes, so some pixels may be drawn twice or keep their default colour.
+*          true: render the full width and height of the original image,
 *                filling in missing nodes using fillmode
+*                Gaps within a row are filled from the nodes at their left and right.
+*                Gaps made by CarveVertical, and any gap with no node at its left or right,
+*                are filled in the same way from the pixels above and below them
+*                (see skipup and skipdown), reading "left" as "above" and "right" as "below".
 * PARAM: fillmode - specifies how to fill gaps
 *          0: solid, uses the same colour as the node at the left of the gap
 *          1: solid, using the averaged values (all channels) of the nodes at the left and right of the gap
@@ -244,78 +351,70 @@ ImgNode* ImgList::SelectNode(ImgNode* rowstart, int selectionmode) {
 */
 PNG ImgList::Render(bool fillgaps, int fillmode) const {
   PNG outpng; //this will be returned later. Might be a good idea to resize it at some point.
+  unsigned int height = rowstarts.size();
+
+  if (!fillgaps) { // create picture without gaps
+    outpng.resize(dimx, dimy);
+    vector<unsigned int> columnshift(dimfullx, 0); // CarveVertical gaps above the current row
+    for (unsigned int y = 0; y < height; y++) {
+      unsigned int rowshift = 0; // Carve gaps to the west of the current position
+      ImgNode *curr = rowstarts[y];
+      unsigned int nextx = curr ? curr->skipleft : dimfullx;
+      for (unsigned int x = 0; x < dimfullx; x++) {
+        if (curr && x == nextx) {
+          unsigned int outx = x - rowshift;
+          unsigned int outy = y - columnshift[x];
+          if (outx < dimx && outy < dimy) {
+            *(outpng.getPixel(outx, outy)) = curr->colour;
+          }
+          nextx += 1 + curr->skipright;
+          curr = curr->east;
+        } else if (columngaps[y * dimfullx + x]) {
+          columnshift[x]++;
+        } else {
+          rowshift++;
+        }
+      }
+    }
+    return outpng;
+  }
+
+  outpng.resize(dimfullx, height);
+  vector<bool> filled(dimfullx * height, false);
 
-  unsigned int width = fillgaps ? GetDimensionFullX() : GetDimensionX();
-  outpng.resize(width, GetDimensionY());
-
-  ImgNode *currRow = northwest;
-  unsigned int y = 0;
-  while (currRow && y < GetDimensionY()) {
-    ImgNode *curr = currRow;
-    unsigned int x = 0;
-    while (curr && x < width) {
-      if (!fillgaps) { // create picture without gaps
-        *(outpng.getPixel(x,y)) = curr->colour;
-      } else {
-        switch(fillmode) {
-          case 0: // copy colour left node beside gap.
-            *(outpng.getPixel(x,y)) = curr->colour;
-            for (unsigned int i=1; i <= curr->skipright; i++) {
-              *(outpng.getPixel(x+i,y)) = curr->colour;
-            }
-            break;
-          case 1: // average of neighbours
-            *(outpng.getPixel(x,y)) = curr->colour;
-            for (unsigned int i=1; i <= curr->skipright; i++) {
-              double hueDiff = HueDiff(curr->colour.h, curr->east->colour.h);
-              double newH = fmin((int) (curr->colour.h + hueDiff / 2) % 360, (int) (curr->east->colour.h + hueDiff / 2) % 360);
-              double newS = (curr->colour.s + curr->east->colour.s) / 2.0;
-              double newL = (curr->colour.l + curr->east->colour.l) / 2.0;
-              double newA = (curr->colour.a + curr->east->colour.a) / 2.0;
-
-              HSLAPixel *pixel = new HSLAPixel(newH, newS, newL, newA);
-              *(outpng.getPixel(x+i,y)) = *pixel;
-              delete pixel;
-            }
-            break;
-          case 2: // gradient
-            *(outpng.getPixel(x,y)) = curr->colour;
-            double DELTA = 0.0000000001;
-            for (unsigned int i=1; i <= curr->skipright; i++) {
-
-
-              double totalHueDiff = HueDiff(curr->colour.h, curr->east->colour.h);
-              if (curr->colour.h + totalHueDiff > 360 && (curr->colour.h + totalHueDiff - 360 - curr->east->colour.h) < DELTA) {
-                totalHueDiff = -totalHueDiff;
-              }
-              if (curr->colour.h + totalHueDiff != curr->east->colour.h) {
-                totalHueDiff = -totalHueDiff;
-              }
-
-              double hDiff = totalHueDiff * i / (curr->skipright+1);
-              double sDiff = curr->colour.s - curr->east->colour.s;
-              double lDiff = curr->colour.l - curr->east->colour.l;
-              double aDiff = curr->colour.a - curr->east->colour.a;
-              double newH = (int) (curr->colour.h + hDiff) % 360;
-              double newS = (curr->colour.s - sDiff * i / (curr->skipright+1));
-              double newL = (curr->colour.l - lDiff * i / (curr->skipright+1));
-              double newA = (curr->colour.a - aDiff * i / (curr->skipright+1));
-
-              HSLAPixel *pixel = new HSLAPixel(newH, newS, newL, newA);
-              *(outpng.getPixel(x+i,y)) = *pixel;
-              delete pixel;
-              pixel = NULL;
-            }
-            break;
+  // draw each node in place, and fill the gaps Carve made between the nodes of each row
+  for (unsigned int y = 0; y < height; y++) {
+    ImgNode *curr = rowstarts[y];
+    unsigned int x = curr ? curr->skipleft : 0;
+    while (curr) {
+      *(outpng.getPixel(x,y)) = curr->colour;
+      filled[y * dimfullx + x] = true;
+      for (unsigned int i=1; curr->east && i <= curr->skipright; i++) {
+        if (!columngaps[y * dimfullx + x + i]) {
+          SetGapColour(outpng.getPixel(x+i,y), curr->colour, curr->east->colour, i, curr->skipright, fillmode);
+          filled[y * dimfullx + x + i] = true;
         }
-        x += curr->skipright;
       }
-      x++;
+      x += 1 + curr->skipright;
       curr = curr->east;
     }
-    y += currRow->skipdown;
-    y++;
-    currRow = currRow->south;
+  }
+
+  // fill the rest of each column between the nodes above and below each gap;
+  // the top and bottom rows never lose nodes to CarveVertical, so they bound every gap
+  for (unsigned int x = 0; x < dimfullx && height > 0; x++) {
+    unsigned int top = 0;
+    HSLAPixel *above = outpng.getPixel(x, 0);
+    ImgNode *curr = colstarts[x];
+    unsigned int y = curr ? curr->skipup : 0;
+    while (curr) {
+      FillColumnGap(outpng, filled, x, top, *above, y, curr->colour, fillmode);
+      top = y;
+      above = &curr->colour;
+      y += 1 + curr->skipdown;
+      curr = curr->south;
+    }
+    FillColumnGap(outpng, filled, x, top, *above, height - 1, *(outpng.getPixel(x, height - 1)), fillmode);
   }
   return outpng;
 }
@@ -332,41 +431,31 @@ PNG ImgList::Render(bool fillgaps, int fillmode) const {
 * PARAM: selectionmode - see the documentation for the SelectNode function.
 * POST: this list has had one node removed from each row. Neighbours of the created
 *       gaps are linked appropriately, and their skip values are updated to reflect
-*       the size of the gap.
+*       the size of the gap. The removed nodes are kept in the carve log as one round,
+*       so that Uncarve can restore them.
 */
 void ImgList::Carve(int selectionmode) {
-  ImgNode *curr = northwest;
-  while (curr) {
-    ImgNode *carve = SelectNode(curr, selectionmode);
-
-    if (!carve) {
-      curr = curr->south;
+  unsigned int carved = 0;
+  for (unsigned int row = 0; row < rowstarts.size(); row++) {
+    if (!rowstarts[row]) {
       continue;
     }
-
-    // add skip and rewire pointers
-    if (carve->north) {
-      carve->north->skipdown += 1 + carve->skipdown;
-      carve->north->south = carve->south;
+    ImgNode *carve = SelectNode(rowstarts[row], selectionmode);
+    if (!carve) {
+      continue;
     }
 
-    if (carve->south) {
-      carve->south->skipup += 1 + carve->skipup;
-    carve->south->north = carve->north;
+    // find the column of the original image the node came from
+    unsigned int column = rowstarts[row]->skipleft;
+    for (ImgNode *curr = rowstarts[row]; curr != carve; curr = curr->east) {
+      column += 1 + curr->skipright;
     }
-
-    carve->east->skipleft += 1 + carve->skipleft;
-    carve->east->west = carve->west;
-
-    carve->west->skipright += 1 + carve->skipright;
-    carve->west->east = carve->east;
-
-    // cleanup
-    delete carve;
-    carve = NULL;
-
-    curr = curr->south;
+    CarveNode(carve, row, column);
+    carved++;
   }
+  CarveRound round = { carved };
+  carverounds.push_back(round);
+  dimx = rowwidths.empty() ? 0 : rowwidths[0];
 }
 
 // note that a node on the boundary will never be selected for removal
@@ -384,11 +473,124 @@ void ImgList::Carve(int selectionmode) {
 *       the size of the gap.
 */
 void ImgList::Carve(unsigned int rounds, int selectionmode) {
-  for (unsigned int i=0; i < rounds; i++) {
+  for (unsigned int i=0; i < rounds && dimx > 2; i++) {
     Carve(selectionmode);
+    carvehistory.push_back(selectionmode);
   }
 }
 
+/*
+* Removes "rounds" number of nodes (up to a maximum of node height - 2) from each column,
+* based on specific selection criteria. This is the vertical counterpart of Carve: each
+* round removes one node from every column, reducing the list's height by one.
+* The first and last nodes in any column cannot be carved.
+* PRE: selectionmode is an integer in the range [0,1]
+* PARAM: rounds - number of nodes to remove from each column
+*        If rounds exceeds node height - 2, then remove only node height - 2 nodes from each column.
+* PARAM: selectionmode - as for SelectNode, with "left" and "right" neighbours
+*        replaced by the neighbours above and below, and ties going to the top-most node.
+* POST: this list has had "rounds" nodes removed from each column. Neighbours of the
+*       created gaps are linked appropriately, and their skip values are updated to
+*       reflect the size of the gap. The removed nodes are kept in the carve log so
+*       that Uncarve can restore them.
+*/
+void ImgList::CarveVertical(unsigned int rounds, int selectionmode) {
+  for (unsigned int i=0; i < rounds && dimy > 2; i++) {
+    CarveColumns(selectionmode);
+    carvehistory.push_back(selectionmode);
+  }
+}
+
+/*
+* Carves rows and columns until this list is at most width x height nodes.
+* While both dimensions are too large, each round compares the mean selection
+* criterion of the best row seam (see Carve) and the best column seam
+* (see CarveVertical), and removes the cheaper one; ties remove a row seam.
+* Neither dimension is reduced below 2, and dimensions that are already small
+* enough are left unchanged.
+* PRE: selectionmode is an integer in the range [0,1]
+* PARAM: width - maximum number of nodes in each row
+* PARAM: height - maximum number of nodes in each column
+* PARAM: selectionmode - see the documentation for the SelectNode function.
+*/
+void ImgList::Retarget(unsigned int width, unsigned int height, int selectionmode) {
+  while (true) {
+    bool carverow = dimx > width && dimx > 2;
+    bool carvecolumn = dimy > height && dimy > 2;
+    if (!carverow && !carvecolumn) {
+      return;
+    }
+    if (carverow && carvecolumn) {
+      carvecolumn = ColumnSeamCost(selectionmode) < RowSeamCost(selectionmode);
+      carverow = !carvecolumn;
+    }
+
+    if (carverow) {
+      Carve(selectionmode);
+    } else {
+      CarveColumns(selectionmode);
+    }
+    carvehistory.push_back(selectionmode);
+  }
+}
+
+/*
+* Restores the nodes removed by the most recent "rounds" carving rounds, undoing
+* the newest round first. Each round costs time proportional to the number of
+* nodes it removed, whether it came from Carve or CarveVertical.
+* PARAM: rounds - number of carving rounds to undo
+*        If rounds exceeds the number of undoable rounds (see DiscardCarveLog),
+*        then only the undoable rounds are restored.
+* POST: the restored nodes are linked back between their original neighbours,
+*       the neighbours' skip values are reduced accordingly, and the list is
+*       identical to its state before those rounds were carved.
+*/
+void ImgList::Uncarve(unsigned int rounds) {
+  for (unsigned int i=0; i < rounds && !carverounds.empty(); i++) {
+    CarveRound round = carverounds.back();
+    carverounds.pop_back();
+    for (unsigned int n = round.size; n > 0; n--) {
+      CarveEntry entry = carvelog.back();
+      carvelog.pop_back();
+      UncarveNode(entry);
+    }
+    carvehistory.pop_back();
+  }
+  dimx = rowwidths.empty() ? 0 : rowwidths[0];
+  dimy = colheights.empty() ? 0 : colheights[0];
+}
+
+/*
+* Carves or uncarves this list until each row holds "width" nodes.
+* Narrowing is limited to a minimum of 2 nodes per row, and widening is limited
+* to the rounds still held in the carve log. Widening also undoes any
+* CarveVertical rounds that were carved after the rounds it restores.
+* PRE: selectionmode is an integer in the range [0,1]
+* PARAM: width - desired number of nodes in each row
+* PARAM: selectionmode - see the documentation for the SelectNode function.
+*        Only used when the list needs to be narrowed.
+*/
+void ImgList::CarveToWidth(unsigned int width, int selectionmode) {
+  if (width < dimx) {
+    Carve(dimx - width, selectionmode);
+  }
+  while (width > dimx && !carverounds.empty()) {
+    Uncarve(1);
+  }
+}
+
+/*
+* Deallocates every node held in the carve log.
+* POST: the carve history is kept, but no round carved so far can be undone.
+*/
+void ImgList::DiscardCarveLog() {
+  for (unsigned int i=0; i < carvelog.size(); i++) {
+    delete carvelog[i].node;
+  }
+  carvelog.clear();
+  carverounds.clear();
+}
+
 
 /*
 * Helper function deallocates all heap memory associated with this list,
@@ -397,16 +599,18 @@ void ImgList::Carve(unsigned int rounds, int selectionmode) {
 *       member attributes have values consistent with an empty list.
 */
 void ImgList::Clear() {
-  ImgNode *currRow = northwest;
-  while (currRow) {
-    ImgNode *curr = currRow;
-    currRow = currRow->south;
-     while (curr) {
+  for (unsigned int row = 0; row < rowstarts.size(); row++) {
+    ImgNode *curr = rowstarts[row];
+    while (curr) {
       ImgNode *temp = curr->east;
       delete curr;
       curr = temp;
-    };
+    }
   }
+  DiscardCarveLog();
+  northwest = NULL;
+  southeast = NULL;
+  ResetMetadata(0, 0);
 }
 
 /* ************************
@@ -418,45 +622,52 @@ void ImgList::Clear() {
 * POST: this list has contents copied from by physically separate from otherlist
 */
 void ImgList::Copy(const ImgList& otherlist) {
-  ImgNode *currRow = otherlist.northwest;
-  vector<ImgNode*> aboveRow = vector<ImgNode*>(otherlist.GetDimensionX(), NULL);
-  
-  unsigned int y = 0;
-  while (currRow) {
-    ImgNode *curr = currRow;
-    ImgNode *left = NULL;
-
-    unsigned int x = 0;
-    while (curr) {
-      ImgNode *node = new ImgNode(*curr);
-      node->north = aboveRow[x];
-      node->west = left;
+  dimx = otherlist.dimx;
+  dimy = otherlist.dimy;
+  dimfullx = otherlist.dimfullx;
+  rowwidths = otherlist.rowwidths;
+  colheights = otherlist.colheights;
+  columngaps = otherlist.columngaps;
+  carvehistory = otherlist.carvehistory;
+  carverounds = otherlist.carverounds;
+  northwest = NULL;
+  southeast = NULL;
+
+  // copy every live node, remembering which original it came from
+  unordered_map<ImgNode*, ImgNode*> copies;
+  for (unsigned int row = 0; row < otherlist.rowstarts.size(); row++) {
+    for (ImgNode *curr = otherlist.rowstarts[row]; curr; curr = curr->east) {
+      copies[curr] = new ImgNode(*curr);
+    }
+  }
 
-      // Set special nodes
-      if (y == 0 && x == 0) {
-        northwest = node;
-      }
-      if (y == otherlist.GetDimensionY() - 1 && x == otherlist.GetDimensionX() - 1) {
-        southeast = node;
-      }
+  // carved nodes are copied too, so that the copy can be uncarved independently
+  carvelog = otherlist.carvelog;
+  for (unsigned int i=0; i < carvelog.size(); i++) {
+    ImgNode *node = new ImgNode(*carvelog[i].node);
+    copies[carvelog[i].node] = node;
+    carvelog[i].node = node;
+  }
 
-      // Set edge cases properly
-      if (left) {
-        left->east = node;
-      }
-      if (aboveRow[x]) {
-        aboveRow[x]->south = node;
-      }
-      
-      // Prepare for next node in row, and nodes the row below
-      left = node;
-      aboveRow[x] = node;
-      curr = curr->east;
-      x++;
+  // link the copies the same way as their originals
+  copies[NULL] = NULL;
+  for (unordered_map<ImgNode*, ImgNode*>::iterator it = copies.begin(); it != copies.end(); it++) {
+    if (it->first) {
+      it->second->north = copies[it->first->north];
+      it->second->east = copies[it->first->east];
+      it->second->south = copies[it->first->south];
+      it->second->west = copies[it->first->west];
     }
-
-    currRow = currRow->south;
-    y++;
+  }
+  northwest = copies[otherlist.northwest];
+  southeast = copies[otherlist.southeast];
+  rowstarts = otherlist.rowstarts;
+  for (unsigned int row = 0; row < rowstarts.size(); row++) {
+    rowstarts[row] = copies[rowstarts[row]];
+  }
+  colstarts = otherlist.colstarts;
+  for (unsigned int column = 0; column < colstarts.size(); column++) {
+    colstarts[column] = copies[colstarts[column]];
   }
 }
 
@@ -464,3 +675,206 @@ void ImgList::Copy(const ImgList& otherlist) {
 * IF YOU DEFINED YOUR OWN PRIVATE FUNCTIONS IN imglist.h, YOU MAY ADD YOUR IMPLEMENTATIONS BELOW *
 *************************************************************************************************/
 
+/*
+* Helper function sets the dimension metadata for a freshly built list of the
+* given size, with every row and column fully populated and no carve history.
+* The row and column starts are set to NULL, for the caller to fill in.
+* PARAM: width - number of nodes in each row
+* PARAM: height - number of rows
+*/
+void ImgList::ResetMetadata(unsigned int width, unsigned int height) {
+  dimx = width;
+  dimy = height;
+  dimfullx = width;
+  rowwidths.assign(height, width);
+  colheights.assign(width, height);
+  rowstarts.assign(height, NULL);
+  colstarts.assign(width, NULL);
+  columngaps.assign(width * height, false);
+  carvehistory.clear();
+}
+
+/*
+* Helper function removes node from the list by linking its neighbours to each
+* other, growing their skip values by the size of the gap node was covering.
+* node's own links and skip values are left untouched.
+* PARAM: node - the node to remove
+*/
+void ImgList::Unlink(ImgNode* node) {
+  if (node->north) {
+    node->north->skipdown += 1 + node->skipdown;
+    node->north->south = node->south;
+  }
+  if (node->south) {
+    node->south->skipup += 1 + node->skipup;
+    node->south->north = node->north;
+  }
+  if (node->east) {
+    node->east->skipleft += 1 + node->skipleft;
+    node->east->west = node->west;
+  }
+  if (node->west) {
+    node->west->skipright += 1 + node->skipright;
+    node->west->east = node->east;
+  }
+}
+
+/*
+* Helper function reverses Unlink, placing node back between the neighbours it
+* was removed from and shrinking their skip values.
+* PRE: node's neighbours are exactly as they were right after node was unlinked,
+*      i.e. nodes are relinked in the reverse order of their removal.
+* PARAM: node - the node to restore
+*/
+void ImgList::Relink(ImgNode* node) {
+  if (node->north) {
+    node->north->skipdown -= 1 + node->skipdown;
+    node->north->south = node;
+  }
+  if (node->south) {
+    node->south->skipup -= 1 + node->skipup;
+    node->south->north = node;
+  }
+  if (node->east) {
+    node->east->skipleft -= 1 + node->skipleft;
+    node->east->west = node;
+  }
+  if (node->west) {
+    node->west->skipright -= 1 + node->skipright;
+    node->west->east = node;
+  }
+}
+
+/*
+* Helper function returns the mean value of the selection criterion over the
+* nodes that Carve(selectionmode) would remove, without modifying the list.
+* PRE: selectionmode is an integer in the range [0,1]
+*/
+double ImgList::RowSeamCost(int selectionmode) {
+  double total = 0;
+  unsigned int count = 0;
+  for (unsigned int row = 0; row < rowstarts.size(); row++) {
+    ImgNode *select = rowstarts[row] ? SelectNode(rowstarts[row], selectionmode) : NULL;
+    if (select) {
+      total += CarveCost(select->west->colour, select->colour, select->east->colour, selectionmode);
+      count++;
+    }
+  }
+  return count == 0 ? 0 : total / count;
+}
+
+/*
+* Helper function returns a pointer to the node of a column which best satisfies
+* the specified selection criteria; the vertical counterpart of SelectNode.
+* The first and last nodes in the column cannot be returned.
+* PRE: selectionmode is an integer in the range [0,1]
+* PARAM: colstart - pointer to the first node in a column
+* PARAM: selectionmode - see the documentation for the SelectNode function, with
+*        "left" and "right" neighbours replaced by the neighbours above and below.
+*        Ties go to the top-most node satisfying the criterion.
+* RETURN: the selected node, or NULL if the column has fewer than 3 nodes
+*/
+ImgNode* ImgList::SelectColumnNode(ImgNode* colstart, int selectionmode) {
+  ImgNode *curr = colstart;
+  ImgNode *min = NULL;
+  double mincost = 0;
+  while (curr->south && curr->south->south) {
+    curr = curr->south;
+    double cost = CarveCost(curr->north->colour, curr->colour, curr->south->colour, selectionmode);
+    if (!min || cost < mincost) {
+      min = curr;
+      mincost = cost;
+    }
+  }
+  return min;
+}
+
+/*
+* Helper function removes one node from each column of this list, as one undoable
+* round; the vertical counterpart of Carve(int). Columns with fewer than 3 nodes
+* are left unchanged.
+* PRE: selectionmode is an integer in the range [0,1]
+* PARAM: selectionmode - see the documentation for the SelectColumnNode function.
+*/
+void ImgList::CarveColumns(int selectionmode) {
+  unsigned int carved = 0;
+  for (unsigned int column = 0; column < colstarts.size(); column++) {
+    if (!colstarts[column]) {
+      continue;
+    }
+    ImgNode *carve = SelectColumnNode(colstarts[column], selectionmode);
+    if (!carve) {
+      continue;
+    }
+
+    // find the row of the original image the node came from
+    unsigned int row = colstarts[column]->skipup;
+    for (ImgNode *curr = colstarts[column]; curr != carve; curr = curr->south) {
+      row += 1 + curr->skipdown;
+    }
+    columngaps[row * dimfullx + column] = true;
+    CarveNode(carve, row, column);
+    carved++;
+  }
+  CarveRound round = { carved };
+  carverounds.push_back(round);
+  dimy = colheights.empty() ? 0 : colheights[0];
+}
+
+/*
+* Helper function returns the mean value of the selection criterion over the
+* nodes that CarveColumns(selectionmode) would remove, without modifying the list.
+* PRE: selectionmode is an integer in the range [0,1]
+*/
+double ImgList::ColumnSeamCost(int selectionmode) {
+  double total = 0;
+  unsigned int count = 0;
+  for (unsigned int column = 0; column < colstarts.size(); column++) {
+    ImgNode *select = colstarts[column] ? SelectColumnNode(colstarts[column], selectionmode) : NULL;
+    if (select) {
+      total += CarveCost(select->north->colour, select->colour, select->south->colour, selectionmode);
+      count++;
+    }
+  }
+  return count == 0 ? 0 : total / count;
+}
+
+/*
+* Helper function removes node from the list and logs it for Uncarve.
+* The node keeps its own links so it can be restored; its row and column lose
+* a node, and take over its neighbour as their start if it was their first node.
+* PARAM: node - the node to remove
+* PARAM: row - row of the original image holding node
+* PARAM: column - column of the original image holding node
+*/
+void ImgList::CarveNode(ImgNode* node, unsigned int row, unsigned int column) {
+  Unlink(node);
+  if (!node->west) {
+    rowstarts[row] = node->east;
+  }
+  if (!node->north) {
+    colstarts[column] = node->south;
+  }
+  rowwidths[row]--;
+  colheights[column]--;
+  CarveEntry entry = { node, row, column };
+  carvelog.push_back(entry);
+}
+
+/*
+* Helper function reverses CarveNode.
+* PRE: entry is the newest entry taken from the carve log
+* PARAM: entry - the carved node and its position in the original image
+*/
+void ImgList::UncarveNode(const CarveEntry& entry) {
+  Relink(entry.node);
+  if (!entry.node->west) {
+    rowstarts[entry.row] = entry.node;
+  }
+  if (!entry.node->north) {
+    colstarts[entry.column] = entry.node;
+  }
+  rowwidths[entry.row]++;
+  colheights[entry.column]++;
+  columngaps[entry.row * dimfullx + entry.column] = false;
+}
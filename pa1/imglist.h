@@ -10,6 +10,8 @@
 #ifndef _IMGLIST_H_
 #define _IMGLIST_H_
 
+#include <vector>
+
 #include "cs221util/PNG.h"
 #include "cs221util/HSLAPixel.h"
 
@@ -69,13 +71,24 @@ class ImgList {
 
     // accessors
     unsigned int GetDimensionX() const; // returns the horizontal dimension of the list (counted in nodes)
-    unsigned int GetDimensionY() const; // returns the vertical dimension of the list (counted in nodes, always matches the full original image height in pixels)
+    unsigned int GetDimensionY() const; // returns the vertical dimension of the list (counted in nodes, matches the full original image height in pixels unless CarveVertical was used)
     unsigned int GetDimensionFullX() const; // returns the horizontal dimension of the list (counted in original pixels, pre-carving)
     PNG Render(bool fillgaps, int fillmode) const; // renders list's pixel data to a PNG, with or without filling gaps caused by carving
 
+    // introspection; all of these run in constant time using metadata maintained by Carve, CarveVertical and Uncarve
+    unsigned int GetRowWidth(unsigned int row) const; // returns the number of live nodes in the given row of the original image, or 0 if the row does not exist
+    unsigned int GetCarveCount() const; // returns the number of rounds applied to this list by Carve, CarveVertical and Retarget
+    const vector<int>& GetCarveHistory() const; // returns the selection mode used by each of those rounds, oldest first
+
     // modifiers
     void Carve(unsigned int rounds, int selectionmode); // removes "rounds" number of pixels (up to a maximum of width - 2) from each row, based on specific criteria
                                                // note that nodes on the left/west and right/east boundaries will never be selected for removal
+    void CarveVertical(unsigned int rounds, int selectionmode); // removes "rounds" number of pixels (up to a maximum of height - 2) from each column, based on specific criteria
+                                                       // note that nodes on the top/north and bottom/south boundaries will never be selected for removal
+    void Retarget(unsigned int width, unsigned int height, int selectionmode); // carves rows and columns, cheapest seam first, until the list is at most width x height nodes
+    void Uncarve(unsigned int rounds); // restores the nodes removed by the most recent "rounds" Carve rounds, newest first
+    void CarveToWidth(unsigned int width, int selectionmode); // carves or uncarves until each row holds "width" nodes, as far as the limits allow
+    void DiscardCarveLog(); // frees all carved nodes; rounds carved so far can no longer be undone
   
     // The following two functions are used ONLY for us (the CPSC 221 staff) to test the structure of your ImgList.
     // None of your other member functions should be calling these.
@@ -87,7 +100,37 @@ class ImgList {
   * YOU MAY DEFINE YOUR OWN PRIVATE MEMBER FUNCTIONS BELOW *
   *********************************************************/
   private:
-    
+    unsigned int dimx;     // number of nodes in each row of the list
+    unsigned int dimy;     // number of nodes in each column of the list
+    unsigned int dimfullx; // width of the original image, counted in pixels
+    vector<unsigned int> rowwidths; // number of live nodes in each row of the original image, indexed from the top
+    vector<unsigned int> colheights; // number of live nodes in each column of the original image, indexed from the left
+    vector<ImgNode*> rowstarts;      // first live node of each row of the original image, NULL if none are left
+    vector<ImgNode*> colstarts;      // first live node of each column of the original image, NULL if none are left
+    vector<bool> columngaps;         // for each original pixel, row by row, whether it was carved by CarveVertical
+    vector<int> carvehistory;       // selection mode of each completed Carve round, oldest first
+
+    struct CarveEntry {
+      ImgNode* node;    // carved node, still holding its links from the moment it was removed
+      unsigned int row;    // row of the original image the node was removed from
+      unsigned int column; // column of the original image the node was removed from
+    };
+    struct CarveRound {
+      unsigned int size; // number of carvelog entries added by this round
+    };
+    vector<CarveEntry> carvelog;     // every undoable carved node, in removal order
+    vector<CarveRound> carverounds;  // every undoable round, oldest first
+
+    void Unlink(ImgNode* node); // detaches node from its neighbours and widens their skip counts
+    void Relink(ImgNode* node); // reverses Unlink; node's neighbours must be exactly those it was removed from
+    double RowSeamCost(int selectionmode); // returns the mean selection criterion of the nodes Carve would remove
+    ImgNode* SelectColumnNode(ImgNode* colstart, int selectionmode); // as SelectNode, for the column starting at colstart
+    void CarveColumns(int selectionmode); // removes a node from each column of the list, as one undoable round
+    double ColumnSeamCost(int selectionmode); // returns the mean selection criterion of the nodes CarveColumns would remove
+    void CarveNode(ImgNode* node, unsigned int row, unsigned int column); // unlinks node, updates the metadata and logs it for Uncarve
+    void UncarveNode(const CarveEntry& entry); // reverses CarveNode for the newest carve log entry
+
+    void ResetMetadata(unsigned int width, unsigned int height); // sets dimensions and clears carve history for a freshly built list
 };
 
 #endif
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "imglist.h"
 
 #include <iostream>
+#include <sstream>
+#include <string>
 
 using namespace std;
 using namespace cs221util;
@@ -15,6 +17,13 @@ using namespace cs221util;
 void TestConstructorRender();
 void TestCarveMode0();
 void TestRenderMode2();
+void TestDimensionMetadata();
+void TestUncarve();
+void TestCarveVertical();
+
+// helper function definitions
+bool SameImage(PNG a, PNG b);
+string Luminances(PNG img);
 
 int main(void) {
 
@@ -23,10 +32,39 @@ int main(void) {
   TestConstructorRender();
   TestCarveMode0();
   TestRenderMode2();
+  TestDimensionMetadata();
+  TestUncarve();
+  TestCarveVertical();
 
   return 0;
 }
 
+// returns true if a and b have the same dimensions and pixel colours
+bool SameImage(PNG a, PNG b) {
+  if (a.width() != b.width() || a.height() != b.height()) {
+    return false;
+  }
+  for (unsigned int y = 0; y < a.height(); y++) {
+    for (unsigned int x = 0; x < a.width(); x++) {
+      if (*a.getPixel(x, y) != *b.getPixel(x, y)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// returns the luminance of every pixel of img, row by row, with rows separated by " / "
+string Luminances(PNG img) {
+  stringstream out;
+  for (unsigned int y = 0; y < img.height(); y++) {
+    for (unsigned int x = 0; x < img.width(); x++) {
+      out << (x == 0 ? (y == 0 ? "" : " / ") : " ") << img.getPixel(x, y)->l;
+    }
+  }
+  return out.str();
+}
+
 void TestConstructorRender() {
   cout << "Entered TestConstructorRender function" << endl;
 
@@ -182,4 +220,204 @@ void TestRenderMode2() {
   else {
     cout << "Input PNG image not read. Exiting..." << endl;
   }
-}
\ No newline at end of file
+}
+
+void TestDimensionMetadata() {
+  cout << "Entered TestDimensionMetadata function" << endl;
+
+  PNG inimg;
+  inimg.readFromFile("input-images/5x6.png");
+
+  if (inimg.height() == 6 && inimg.width() == 5) {
+    cout << "Creating ImgList object using input PNG... ";
+    ImgList list5x6(inimg);
+    cout << "done." << endl;
+
+    cout << "Carving list once in mode 0 and once in mode 1... ";
+    list5x6.Carve(1, 0);
+    list5x6.Carve(1, 1);
+    cout << "done." << endl;
+
+    cout << "Expected dimensions (x, y, fullx): (3, 6, 5)" << endl;
+    cout << "Your dimensions (x, y, fullx): (" << list5x6.GetDimensionX() << ", "
+         << list5x6.GetDimensionY() << ", " << list5x6.GetDimensionFullX() << ")" << endl;
+
+    cout << "Expected row widths: 3 3 3 3 3 3 0" << endl;
+    cout << "Your row widths:";
+    for (unsigned int y = 0; y <= list5x6.GetDimensionY(); y++) {
+      cout << " " << list5x6.GetRowWidth(y);
+    }
+    cout << endl;
+
+    cout << "Attempting to carve more pixels than allowable in mode 0... ";
+    list5x6.Carve(10, 0);
+    cout << "done." << endl;
+
+    cout << "Copying carved list... ";
+    ImgList copy5x6(list5x6);
+    cout << "done." << endl;
+
+    cout << "Expected carve history: 0 1 0" << endl;
+    cout << "Your carve history:";
+    for (unsigned int i = 0; i < copy5x6.GetCarveCount(); i++) {
+      cout << " " << copy5x6.GetCarveHistory()[i];
+    }
+    cout << endl;
+
+    cout << "Expected horizontal dimension of copy: 2" << endl;
+    cout << "Your horizontal dimension of copy: " << copy5x6.GetDimensionX() << endl;
+
+    cout << "Exiting TestDimensionMetadata function" << endl;
+  }
+  else {
+    cout << "Input PNG image not read. Exiting..." << endl;
+  }
+}
+
+void TestUncarve() {
+  cout << "Entered TestUncarve function" << endl;
+
+  PNG inimg;
+  inimg.readFromFile("input-images/6x6grad.png");
+
+  if (inimg.height() == 6 && inimg.width() == 6) {
+    cout << "Creating ImgList object using input PNG... ";
+    ImgList list6x6(inimg);
+    PNG original = list6x6.Render(false, 0);
+    cout << "done." << endl;
+
+    cout << "Carving list three times in mode 1... ";
+    list6x6.Carve(3, 1);
+    PNG carved = list6x6.Render(true, 2);
+    cout << "done." << endl;
+
+    cout << "Copying carved list and uncarving the copy completely... ";
+    ImgList copy6x6(list6x6);
+    copy6x6.Uncarve(10);
+    cout << "done." << endl;
+
+    cout << "Expected copy matches original: 1" << endl;
+    cout << "Your copy matches original: " << SameImage(copy6x6.Render(false, 0), original) << endl;
+    cout << "Expected carved list unchanged by copy's uncarve: 1" << endl;
+    cout << "Your carved list unchanged by copy's uncarve: " << SameImage(list6x6.Render(true, 2), carved) << endl;
+
+    cout << "Jumping carved list to width 2, then back to width 5... ";
+    list6x6.CarveToWidth(2, 0);
+    list6x6.CarveToWidth(5, 0);
+    cout << "done." << endl;
+
+    cout << "Expected horizontal dimension: 5" << endl;
+    cout << "Your horizontal dimension: " << list6x6.GetDimensionX() << endl;
+    cout << "Expected carve count: 1" << endl;
+    cout << "Your carve count: " << list6x6.GetCarveCount() << endl;
+
+    cout << "Uncarving remaining round... ";
+    list6x6.Uncarve(1);
+    cout << "done." << endl;
+
+    cout << "Expected list matches original: 1" << endl;
+    cout << "Your list matches original: " << SameImage(list6x6.Render(true, 0), original) << endl;
+
+    cout << "Exiting TestUncarve function" << endl;
+  }
+  else {
+    cout << "Input PNG image not read. Exiting..." << endl;
+  }
+}
+
+void TestCarveVertical() {
+  cout << "Entered TestCarveVertical function" << endl;
+
+  cout << "Creating 2x4 ImgList object with known luminances... ";
+  double lum[2][4] = { { 0.1, 0.9, 0.2, 0.3 }, { 0.5, 0.4, 0.6, 0.7 } };
+  PNG smallimg(2, 4);
+  for (unsigned int x = 0; x < 2; x++) {
+    for (unsigned int y = 0; y < 4; y++) {
+      *smallimg.getPixel(x, y) = HSLAPixel(0, 0, lum[x][y]);
+    }
+  }
+  ImgList list2x4(smallimg);
+  cout << "done." << endl;
+
+  cout << "Carving one node from each column using selection mode 0... ";
+  list2x4.CarveVertical(1, 0);
+  PNG smallout = list2x4.Render(false, 0);
+  cout << "done." << endl;
+
+  cout << "Expected dimensions (x, y): (2, 3)" << endl;
+  cout << "Your dimensions (x, y): (" << list2x4.GetDimensionX() << ", " << list2x4.GetDimensionY() << ")" << endl;
+  cout << "Expected luminances: 0.1 0.5 / 0.9 0.6 / 0.3 0.7" << endl;
+  cout << "Your luminances:";
+  for (unsigned int y = 0; y < smallout.height(); y++) {
+    cout << (y == 0 ? " " : " / ") << smallout.getPixel(0, y)->l << " " << smallout.getPixel(1, y)->l;
+  }
+  cout << endl;
+
+  cout << "Expected filled luminances (fillmode 0): 0.1 0.5 / 0.9 0.5 / 0.9 0.6 / 0.3 0.7" << endl;
+  cout << "Your filled luminances (fillmode 0): " << Luminances(list2x4.Render(true, 0)) << endl;
+  cout << "Expected filled luminances (fillmode 1): 0.1 0.5 / 0.9 0.55 / 0.6 0.6 / 0.3 0.7" << endl;
+  cout << "Your filled luminances (fillmode 1): " << Luminances(list2x4.Render(true, 1)) << endl;
+
+  cout << "Creating 4x4 ImgList object with known luminances... ";
+  double grid[4][4] = { { 0.9, 0.9, 0.9, 0.9 }, { 0.5, 0.1, 0.8, 0.9 },
+                        { 0.5, 0.7, 0.2, 0.9 }, { 0.9, 0.9, 0.9, 0.9 } };
+  PNG gridimg(4, 4);
+  for (unsigned int x = 0; x < 4; x++) {
+    for (unsigned int y = 0; y < 4; y++) {
+      *gridimg.getPixel(x, y) = HSLAPixel(0, 0, grid[y][x]);
+    }
+  }
+  ImgList list4x4(gridimg);
+  cout << "done." << endl;
+
+  cout << "Retargeting list to 3x3 using selection mode 0, a column round then a row round... ";
+  list4x4.Retarget(3, 3, 0);
+  cout << "done." << endl;
+
+  cout << "Expected dimensions (x, y): (3, 3)" << endl;
+  cout << "Your dimensions (x, y): (" << list4x4.GetDimensionX() << ", " << list4x4.GetDimensionY() << ")" << endl;
+  cout << "Expected filled luminances (fillmode 1): 0.9 0.9 0.9 0.9 / 0.7 0.9 0.8 0.9 / 0.5 0.7 0.85 0.9 / 0.9 0.9 0.9 0.9" << endl;
+  cout << "Your filled luminances (fillmode 1): " << Luminances(list4x4.Render(true, 1)) << endl;
+
+  list4x4.Uncarve(2);
+  cout << "Expected list matches original after uncarving: 1" << endl;
+  cout << "Your list matches original after uncarving: " << SameImage(list4x4.Render(true, 0), gridimg) << endl;
+
+  PNG inimg;
+  inimg.readFromFile("input-images/6x6grad.png");
+
+  if (inimg.height() == 6 && inimg.width() == 6) {
+    cout << "Creating ImgList object using input PNG... ";
+    ImgList list6x6(inimg);
+    PNG original = list6x6.Render(false, 0);
+    cout << "done." << endl;
+
+    cout << "Retargeting list to 4x3 using selection mode 1... ";
+    list6x6.Retarget(4, 3, 1);
+    PNG retargeted = list6x6.Render(false, 0);
+    cout << "done." << endl;
+
+    cout << "Expected dimensions (x, y): (4, 3)" << endl;
+    cout << "Your dimensions (x, y): (" << list6x6.GetDimensionX() << ", " << list6x6.GetDimensionY() << ")" << endl;
+    cout << "Expected rendered dimensions (x, y): (4, 3)" << endl;
+    cout << "Your rendered dimensions (x, y): (" << retargeted.width() << ", " << retargeted.height() << ")" << endl;
+    cout << "Expected carve count: 5" << endl;
+    cout << "Your carve count: " << list6x6.GetCarveCount() << endl;
+
+    cout << "Writing output PNG to 6x6-retarget.png... ";
+    retargeted.writeToFile("output-images/6x6-retarget.png");
+    cout << "done." << endl;
+
+    cout << "Uncarving all rounds... ";
+    list6x6.Uncarve(5);
+    cout << "done." << endl;
+
+    cout << "Expected list matches original: 1" << endl;
+    cout << "Your list matches original: " << SameImage(list6x6.Render(false, 0), original) << endl;
+
+    cout << "Exiting TestCarveVertical function" << endl;
+  }
+  else {
+    cout << "Input PNG image not read. Exiting..." << endl;
+  }
+}
@@ -7,78 +7,172 @@
  */
 
 #include <iostream>
-#include <sstream>
-#include <stdlib.h>
+#include <stdio.h>
 #include <string>
-#include <sys/stat.h>
 
 #include "animation.h"
 
 using namespace std;
 
-template <typename T> inline string animation::to_string(const T &value)
+void animation::addFrame(PNG const &img)
 {
-    stringstream ss;
-    ss << value;
-    return ss.str();
+    if (!hasBase)
+    {
+        setBase(img);
+        endFrame();
+        return;
+    }
+
+    if (gif)
+    {
+        gif->SetImage(img);
+        current = img;
+        endFrame();
+        return;
+    }
+
+    // Compare against the latest frame, rebuilding it if pixels were
+    // recorded since the last call
+    if (!hasCurrent)
+    {
+        current = base;
+        applyChanges(current, 0, changes.size());
+        hasCurrent = true;
+    }
+    unsigned int width = base.width();
+    for (unsigned int y = 0; y < base.height(); y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
+        {
+            HSLAPixel *pixel = img.getPixel(x, y);
+            if (!samePixel(*pixel, *current.getPixel(x, y)))
+                recordPixel(x, y, *pixel);
+        }
+    }
+    endFrame();
 }
 
-string animation::getString(int i, int padToSameLengthAs)
+bool animation::stream(const std::string &filename)
 {
-    string istr = to_string(i);
-    string padstr = to_string(padToSameLengthAs);
-    return string(padstr.length() - istr.length(), '0') + istr;
+    streamFile = filename;
+    gif = make_shared<GifWriter>();
+    if (!hasBase)
+        return true;
+    PNG img(base);
+    setBase(img);
+    return gif->IsOpen();
 }
 
-bool animation::exists(const string &path)
+void animation::setBase(PNG const &img)
 {
-    // Try stat-ing it
-    struct stat st;
-    if (stat(path.c_str(), &st) != 0)
-        return false;
-    // Check for read permission
-    if ((st.st_mode & S_IRUSR) == 0)
-        return false;
-
-    // Check for correct file/directory nature
-    if (path[path.length() - 1] != '/')
-        return S_ISREG(st.st_mode);
-
-    // Otherwise we want a directory
-    if ((st.st_mode & S_IXUSR) == 0)
-        return false;
-    return S_ISDIR(st.st_mode);
+    hasBase = true;
+    changes.clear();
+    frameEnds.clear();
+    if (gif)
+    {
+        // Only the latest frame is needed while streaming
+        current = img;
+        hasCurrent = true;
+        base = PNG();
+        if (!gif->IsOpen() && !gif->Open(streamFile, img.width(), img.height()))
+            cerr << "Animation Error: could not create " << streamFile << endl;
+        if (gif->IsOpen())
+            gif->SetImage(img);
+        return;
+    }
+    base = img;
+    current = PNG();
+    hasCurrent = false;
 }
 
-void animation::addFrame(PNG const &img)
+void animation::recordPixel(unsigned int x, unsigned int y, HSLAPixel const &pixel)
+{
+    if (hasCurrent)
+        *current.getPixel(x, y) = pixel;
+    if (gif)
+    {
+        if (gif->IsOpen())
+            gif->SetPixel(x, y, pixel);
+        return;
+    }
+    PixelChange change;
+    change.index = y * base.width() + x;
+    change.pixel = pixel;
+    changes.push_back(change);
+}
+
+void animation::endFrame()
 {
-    frames.push_back(img);
+    if (gif && gif->IsOpen())
+        gif->WriteFrame();
+    frameEnds.push_back(changes.size());
+}
+
+size_t animation::frameCount() const
+{
+    return frameEnds.size();
+}
+
+PNG animation::getFrame(size_t i) const
+{
+    PNG frame(base);
+    applyChanges(frame, 0, frameEnds[i]);
+    return frame;
+}
+
+void animation::applyChanges(PNG &img, size_t begin, size_t end) const
+{
+    unsigned int width = img.width();
+    for (size_t i = begin; i < end; i++)
+        *img.getPixel(changes[i].index % width, changes[i].index / width) = changes[i].pixel;
+}
+
+bool animation::samePixel(HSLAPixel const &a, HSLAPixel const &b)
+{
+    return a.h == b.h && a.s == b.s && a.l == b.l && a.a == b.a;
 }
 
 PNG animation::write(const std::string &filename)
 {
-    if (frames.empty())
+    if (frameEnds.empty())
     {
         cout << "Animation Warning: No frames added!" << endl;
         return PNG();
     }
-    size_t filestart = filename.find_last_of("/");
-    filestart = (filestart == string::npos) ? 0 : filestart + 1;
-    size_t extstart = filename.find_last_of(".");
-    string name = filename.substr(filestart, extstart - filestart);
-
-    // Create the frames/ directory if it does not exist
-    if (!exists("frames/"))
-        mkdir("frames", 0700);
-
-    // Remove all previous frames from this image
-    system(("ls frames | grep '^" + name + ".*\\.png$' | xargs -I% rm -f frames/%").c_str());
 
-    // Generate Frames
-    for (size_t i = 0; i < frames.size(); i++)
-        frames[i].writeToFile(("frames/" + name + getString(i, frames.size()) + ".png").c_str());
+    if (gif)
+    {
+        if (gif->IsOpen())
+            gif->Close();
+        if (filename != streamFile && rename(streamFile.c_str(), filename.c_str()) != 0)
+            cerr << "Animation Error: could not rename " << streamFile << " to " << filename << endl;
+        return current;
+    }
 
-    // Combine frames
-    system(("convert frames/" + name + "*.png " + filename).c_str());
-    return frames[frames.size() - 1];
+    // Replay the changes onto both the encoder's canvas and a copy of the
+    // base image, encoding each frame as it is completed
+    GifWriter writer;
+    if (!writer.Open(filename, base.width(), base.height()))
+        cerr << "Animation Error: could not create " << filename << endl;
+    writer.SetImage(base);
+    PNG frame(base);
+    unsigned int width = base.width();
+    size_t begin = 0;
+    for (size_t i = 0; i < frameEnds.size(); i++)
+    {
+        for (size_t c = begin; c < frameEnds[i]; c++)
+        {
+            unsigned int x = changes[c].index % width;
+            unsigned int y = changes[c].index / width;
+            *frame.getPixel(x, y) = changes[c].pixel;
+            if (writer.IsOpen())
+                writer.SetPixel(x, y, changes[c].pixel);
+        }
+        begin = frameEnds[i];
+        if (writer.IsOpen())
+            writer.WriteFrame();
+    }
+    if (writer.IsOpen())
+        writer.Close();
+    return frame;
 }
@@ -10,10 +10,13 @@
 #ifndef _ANIMATION_H_
 #define _ANIMATION_H_
 
+#include <memory>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
 #include "cs221util/PNG.h"
+#include "gifwriter.h"
 
 using namespace std;
 using namespace cs221util;
@@ -22,6 +25,13 @@ using namespace cs221util;
  * Animation class---used to create animated images from a sequence of PNG
  * objects as frames of the animation.
  *
+ * Only the first frame (or the image given to setBase) is stored in full.
+ * Every later frame is stored as the list of pixels that changed since the
+ * frame before it, and full frames are rebuilt from these when needed.
+ *
+ * Alternatively, an animation can be streamed: each frame is encoded to a
+ * GIF file as soon as it is added, and only the latest frame is kept.
+ *
  * @author Aria Buckles
  * @date Fall 2011
  */
@@ -36,18 +46,86 @@ class animation
     void addFrame(const PNG &img);
 
     /**
-     * Writes the animation to the file name specified.
+     * Starts streaming the animation to a GIF file. Every frame added from
+     * now on is encoded straight away instead of being kept.
+     *
+     * @pre No frames have been added yet.
+     * @param filename The name of the file to be written to.
+     * @return Whether the file could be created (once the image size is
+     *  known, i.e. straight away if setBase has been called).
+     */
+    bool stream(const std::string &filename);
+
+    /**
+     * Sets the image that recorded pixel changes apply to, discarding any
+     * frames already added. The base image is not itself a frame.
+     *
+     * @param img The image before any recorded changes.
+     */
+    void setBase(const PNG &img);
+
+    /**
+     * Records that a pixel has changed, to be included in the next frame
+     * ended by endFrame. Much cheaper than addFrame for images where only a
+     * few pixels change between frames.
+     *
+     * @pre setBase or addFrame has been called, and (x, y) lies within the image.
+     * @param x The x-coordinate of the changed pixel.
+     * @param y The y-coordinate of the changed pixel.
+     * @param pixel The new value of the pixel.
+     */
+    void recordPixel(unsigned int x, unsigned int y, const HSLAPixel &pixel);
+
+    /**
+     * Adds a frame made of the previous frame (or the base image) with every
+     * change recorded since then applied.
+     */
+    void endFrame();
+
+    /**
+     * @return The number of frames in the animation.
+     */
+    size_t frameCount() const;
+
+    /**
+     * Rebuilds a frame of the animation.
+     *
+     * @pre i < frameCount(), and the animation is not being streamed.
+     * @param i The index of the frame.
+     * @return The frame.
+     */
+    PNG getFrame(size_t i) const;
+
+    /**
+     * Writes the animation to the file name specified as a GIF, rebuilding
+     * and encoding one frame at a time. If the animation is being streamed,
+     * finishes the streamed file instead, renaming it to filename if needed.
      *
      * @param filename The name of the file to be written to.
+     * @return The last frame of the animation.
      */
     PNG write(const std::string &filename);
 
   private:
-    std::vector<PNG> frames;
+    /**
+     * A pixel of a frame that differs from the frame before it.
+     */
+    struct PixelChange {
+        uint32_t index;  // row-major index of the pixel
+        HSLAPixel pixel; // new value of the pixel
+    };
+
+    PNG base;                     // image the changes are applied to
+    bool hasBase = false;         // whether base has been set
+    vector<PixelChange> changes;  // changes of every frame, in order
+    vector<size_t> frameEnds;     // frameEnds[i] is the end of frame i's changes
+    PNG current;                  // base with every change applied, kept for addFrame and streaming
+    bool hasCurrent = false;      // whether current is up to date
+    shared_ptr<GifWriter> gif;    // encoder of a streamed animation, or null
+    string streamFile;            // name of the streamed file
 
-    template <typename T> string to_string(const T &value);
-    string getString(int i, int padToSameLengthAs);
-    bool exists(const string &path);
+    void applyChanges(PNG &img, size_t begin, size_t end) const;
+    static bool samePixel(const HSLAPixel &a, const HSLAPixel &b);
 };
 
 #endif
@@ -0,0 +1,450 @@
+/*
+* File:        benchFills.cpp
+* Description: Benchmark of the DFS and BFS fills with every color picker,
+*              over the images in originals/ and two large synthetic images,
+*              at several frame frequencies.
+*
+*              For each fill, prints the filled pixels per second, the bytes
+*              allocated per filled pixel, and how the fill's time divides
+*              between:
+*                picker   - ColorPicker calls, timed individually through a
+*                           wrapping picker, less the cost of reading the clock
+*                priority - ordering neighbours with PriorityNeighbours, timed
+*                           by replaying filler::neighbourOrder for each filled
+*                           pixel in fill order (an estimate: the replay treats
+*                           every out-of-tolerance pixel as already visited)
+*                frames   - capturing animation frames, the difference from
+*                           the same fill with a single final frame
+*                loop     - everything else: tolerance tests, the ordering
+*                           structure, visiting and recording pixels
+*              and the time to encode the animation to a GIF afterwards.
+*
+*              Then times FillSeeds on a checkerboard of SEEDCELLS x SEEDCELLS
+*              cells, one seed per cell, at 1, 2, 4 and one thread per
+*              hardware thread, with the speedup over a single thread.
+*              Exploration is spread over the threads, but painting runs on
+*              the calling thread, which bounds the speedup.
+*
+*              Whole-fill times are the fastest of REPEATS runs.
+*
+*              Usage: benchFills [synthetic image size, default 256]
+*
+* Date:        2026-10-19
+*
+*/
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits.h>
+#include <new>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cs221util/PNG.h"
+#include "cs221util/HSLAPixel.h"
+#include "filler.h"
+#include "solidColorPicker.h"
+#include "imageTileColorPicker.h"
+#include "negativeColorPicker.h"
+#include "censorColorPicker.h"
+#include "rainbowColorPicker.h"
+
+using namespace std;
+using namespace cs221util;
+
+#define BENCHGIF "images/bench.gif"
+#define TILEIMAGE "originals/strawberry.png"
+#define CENSORBLOCKWIDTH 10
+#define RAINBOWFREQ 1.0/1000.0
+#define REPEATS 3
+#define SEEDCELLS 16
+
+/*
+*  Every allocation made by the program is counted, so that the bytes a fill
+*  allocates can be measured.
+*/
+static atomic<size_t> allocatedBytes(0);
+
+void* operator new(size_t size) {
+  allocatedBytes += size;
+  void* p = malloc(size == 0 ? 1 : size);
+  if (p == NULL) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+/*
+*  Wraps another picker, timing each of its calls and recording the points
+*  it was called for, in order.
+*/
+class TimedColorPicker : public ColorPicker {
+  public:
+    TimedColorPicker(ColorPicker& picker) : inner(picker), nanos(0) {}
+
+    virtual HSLAPixel operator()(PixelPoint p) {
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      HSLAPixel color = inner(p);
+      nanos += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+      points.push_back(p);
+      return color;
+    }
+
+    ColorPicker& inner;
+    double nanos;              // total time spent in inner's calls
+    vector<PixelPoint> points; // points picked, with their original colours
+};
+
+// an image to fill, and the seed and tolerance to fill it with
+struct BenchImage {
+  string name;
+  PNG img;
+  unsigned int seedx;
+  unsigned int seedy;
+  double tolerance;
+};
+
+// one fill's measurements
+struct BenchResult {
+  size_t pixels;       // pixels filled
+  double fillNanos;    // time of the whole fill
+  double pickerNanos;  // time in picker calls
+  double priorityNanos;// time ordering neighbours
+  double frameNanos;   // time capturing frames
+  double writeNanos;   // time encoding the animation afterwards
+  size_t bytes;        // bytes allocated by the fill
+};
+
+/*
+*  Constructs a fresh picker of the given kind for an image, so that
+*  stateful pickers (rainbow) start over for every fill.
+*/
+ColorPicker* MakePicker(const string& kind, BenchImage& image, PNG& tile) {
+  PixelPoint center(image.seedx, image.seedy, HSLAPixel());
+  if (kind == "solid") {
+    return new SolidColorPicker(HSLAPixel(100., 1.0, 0.5));
+  } else if (kind == "negative") {
+    return new NegativeColorPicker(image.img);
+  } else if (kind == "imagetile") {
+    return new ImageTileColorPicker(tile);
+  } else if (kind == "censor") {
+    unsigned int radius = min(image.img.width(), image.img.height()) / 3;
+    return new CensorColorPicker(CENSORBLOCKWIDTH, center, radius, image.img);
+  }
+  return new RainbowColorPicker(RAINBOWFREQ);
+}
+
+filler::FillerConfig MakeConfig(BenchImage& image, ColorPicker* picker, int frameFreq) {
+  filler::FillerConfig config;
+  config.img = image.img;
+  config.frameFreq = frameFreq;
+  config.tolerance = image.tolerance;
+  config.seedpoint = PixelPoint(image.seedx, image.seedy, *image.img.getPixel(image.seedx, image.seedy));
+  config.picker = picker;
+  return config;
+}
+
+animation RunFill(const string& order, filler::FillerConfig& config) {
+  return order == "dfs" ? filler::FillDFS(config) : filler::FillBFS(config);
+}
+
+/*
+*  Returns the mean cost of reading the steady clock, which is paid once per
+*  picker call by TimedColorPicker.
+*/
+double ClockNanos() {
+  const int reads = 100000;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (int i = 0; i < reads; i++) {
+    chrono::steady_clock::now();
+  }
+  return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / reads;
+}
+
+/*
+*  Replays the neighbour ordering the fill did for each filled pixel.
+*/
+double PriorityNanos(BenchImage& image, vector<PixelPoint> const& points) {
+  filler::FillerConfig config = MakeConfig(image, NULL, INT_MAX);
+  ToleranceMask mask(image.img, config.seedpoint.color, config.tolerance);
+  PixelBitmap outside(image.img.width(), image.img.height());
+  for (unsigned int y = 0; y < image.img.height(); y++) {
+    for (unsigned int x = 0; x < image.img.width(); x++) {
+      if (!mask.Get(x, y)) {
+        outside.Set(x, y);
+      }
+    }
+  }
+
+  double best = 0;
+  for (int r = 0; r < REPEATS; r++) {
+    PixelBitmap visited = outside;
+    volatile unsigned int checksum = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (size_t i = 0; i < points.size(); i++) {
+      visited.Set(points[i].x, points[i].y);
+      checksum = checksum + filler::neighbourOrder(points[i].x, points[i].y, points[i].color, visited, config);
+    }
+    double nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    best = r == 0 ? nanos : min(best, nanos);
+  }
+  return best;
+}
+
+/*
+*  Runs a fill with a fresh picker, returning the animation and the time the
+*  fill took, and counting the bytes it allocated.
+*/
+animation TimeFill(BenchImage& image, PNG& tile, const string& kind, const string& order,
+                   int frameFreq, double& nanos, size_t& bytes) {
+  ColorPicker* picker = MakePicker(kind, image, tile);
+  filler::FillerConfig config = MakeConfig(image, picker, frameFreq);
+  size_t bytesBefore = allocatedBytes;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  animation anim = RunFill(order, config);
+  nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+  bytes = allocatedBytes - bytesBefore;
+  delete picker;
+  return anim;
+}
+
+BenchResult BenchFill(BenchImage& image, PNG& tile, const string& kind, const string& order,
+                      int frameFreq, double clockNanos) {
+  BenchResult result;
+
+  // the fill as it is normally run, and with only the final frame
+  double unframedNanos = 0;
+  animation anim;
+  for (int r = 0; r < REPEATS; r++) {
+    double nanos, unframed;
+    size_t bytes;
+    anim = TimeFill(image, tile, kind, order, frameFreq, nanos, result.bytes);
+    TimeFill(image, tile, kind, order, INT_MAX, unframed, bytes);
+    result.fillNanos = r == 0 ? nanos : min(result.fillNanos, nanos);
+    unframedNanos = r == 0 ? unframed : min(unframedNanos, unframed);
+  }
+  result.frameNanos = max(result.fillNanos - unframedNanos, 0.0);
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  anim.write(BENCHGIF);
+  result.writeNanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+  // the same fill with its picker calls timed
+  ColorPicker* picker = MakePicker(kind, image, tile);
+  TimedColorPicker timed(*picker);
+  filler::FillerConfig config = MakeConfig(image, &timed, frameFreq);
+  RunFill(order, config);
+  result.pixels = timed.points.size();
+  result.pickerNanos = max(timed.nanos - clockNanos * result.pixels, 0.0);
+  delete picker;
+
+  result.priorityNanos = PriorityNanos(image, timed.points);
+  return result;
+}
+
+double Percent(double part, double whole) {
+  return whole > 0 ? 100 * part / whole : 0;
+}
+
+void PrintHeader() {
+  cout << left << setw(16) << "image" << setw(11) << "picker" << setw(5) << "fill" << right
+       << setw(7) << "freq" << setw(9) << "pixels" << setw(10) << "fill ms" << setw(9) << "Mpx/s"
+       << setw(8) << "picker" << setw(10) << "priority" << setw(8) << "frames" << setw(7) << "loop"
+       << setw(10) << "write ms" << setw(9) << "bytes/px" << endl;
+}
+
+void PrintResult(const string& image, const string& kind, const string& order, int frameFreq,
+                 BenchResult const& result) {
+  double loopNanos = max(result.fillNanos - result.pickerNanos - result.priorityNanos - result.frameNanos, 0.0);
+  double pixels = max(result.pixels, (size_t) 1);
+  cout << left << setw(16) << image << setw(11) << kind << setw(5) << order << right
+       << setw(7) << frameFreq << setw(9) << result.pixels
+       << fixed << setprecision(2)
+       << setw(10) << result.fillNanos / 1e6
+       << setw(9) << result.pixels / (result.fillNanos / 1e3)
+       << setprecision(0)
+       << setw(7) << Percent(result.pickerNanos, result.fillNanos) << "%"
+       << setw(9) << Percent(result.priorityNanos, result.fillNanos) << "%"
+       << setw(7) << Percent(result.frameNanos, result.fillNanos) << "%"
+       << setw(6) << Percent(loopNanos, result.fillNanos) << "%"
+       << setprecision(2)
+       << setw(10) << result.writeNanos / 1e6
+       << setprecision(1)
+       << setw(9) << result.bytes / pixels << endl;
+}
+
+BenchImage LoadImage(const string& name, unsigned int seedx, unsigned int seedy, double tolerance) {
+  BenchImage image;
+  image.name = name;
+  image.img.readFromFile("originals/" + name + ".png");
+  image.seedx = seedx;
+  image.seedy = seedy;
+  image.tolerance = tolerance;
+  return image;
+}
+
+/*
+*  A size x size image of one colour with slight, random variations in
+*  lightness, all within tolerance of each other: the fill covers it all.
+*/
+BenchImage FlatImage(unsigned int size) {
+  BenchImage image;
+  image.name = "synthetic-flat";
+  image.img.resize(size, size);
+  for (unsigned int y = 0; y < size; y++) {
+    for (unsigned int x = 0; x < size; x++) {
+      *image.img.getPixel(x, y) = HSLAPixel(200., 0.6, 0.5 + (rand() % 100) / 10000.0);
+    }
+  }
+  image.seedx = size / 2;
+  image.seedy = size / 2;
+  image.tolerance = 0.01;
+  return image;
+}
+
+/*
+*  A size x size maze: corridors of the flat image's colour, separated by
+*  walls of another colour with a gap at alternating ends, so the fill
+*  winds back and forth along a long path.
+*/
+BenchImage MazeImage(unsigned int size) {
+  BenchImage image = FlatImage(size);
+  image.name = "synthetic-maze";
+  for (unsigned int y = 3; y < size; y += 4) {
+    unsigned int gap = (y / 4) % 2 == 0 ? size - 1 : 0;
+    for (unsigned int x = 0; x < size; x++) {
+      if (x != gap) {
+        *image.img.getPixel(x, y) = HSLAPixel(20., 0.9, 0.3);
+      }
+    }
+  }
+  image.seedx = 0;
+  image.seedy = 0;
+  return image;
+}
+
+/*
+*  A size x size checkerboard of SEEDCELLS x SEEDCELLS cells in two hues
+*  far apart, so that each cell is a region of its own.
+*/
+BenchImage CellImage(unsigned int size) {
+  BenchImage image = FlatImage(size);
+  image.name = "synthetic-cells";
+  unsigned int cell = max(size / SEEDCELLS, 1u);
+  for (unsigned int y = 0; y < size; y++) {
+    for (unsigned int x = 0; x < size; x++) {
+      if ((x / cell + y / cell) % 2 == 1) {
+        *image.img.getPixel(x, y) = HSLAPixel(20., 0.9, 0.3);
+      }
+    }
+  }
+  return image;
+}
+
+/*
+*  Times FillSeeds with a seed at the centre of every cell of a CellImage,
+*  at each thread count.
+*/
+void BenchSeeds(BenchImage& image) {
+  unsigned int cell = max(image.img.width() / SEEDCELLS, 1u);
+  vector<PixelPoint> seeds;
+  for (unsigned int y = cell / 2; y < image.img.height(); y += cell) {
+    for (unsigned int x = cell / 2; x < image.img.width(); x += cell) {
+      seeds.push_back(PixelPoint(x, y, *image.img.getPixel(x, y)));
+    }
+  }
+
+  vector<unsigned int> threads;
+  threads.push_back(1);
+  threads.push_back(2);
+  threads.push_back(4);
+  unsigned int hardware = max(thread::hardware_concurrency(), 1u);
+  if (hardware != 1 && hardware != 2 && hardware != 4) {
+    threads.push_back(hardware);
+  }
+
+  cout << endl << image.name << " " << image.img.width() << " x " << image.img.height()
+       << ", FillSeeds with " << seeds.size() << " seeds" << endl;
+  cout << right << setw(8) << "threads" << setw(10) << "fill ms" << setw(9) << "Mpx/s"
+       << setw(9) << "speedup" << endl;
+
+  SolidColorPicker picker(HSLAPixel(100., 1.0, 0.5));
+  double pixels = (double) image.img.width() * image.img.height();
+  double single = 0;
+  for (size_t t = 0; t < threads.size(); t++) {
+    double best = 0;
+    for (int r = 0; r < REPEATS; r++) {
+      filler::FillerConfig config = MakeConfig(image, &picker, INT_MAX);
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      filler::FillSeeds(config, seeds, vector<ColorPicker*>(), threads[t]);
+      double nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+      best = r == 0 ? nanos : min(best, nanos);
+    }
+    if (t == 0) {
+      single = best;
+    }
+    cout << setw(8) << threads[t] << fixed << setprecision(2)
+         << setw(10) << best / 1e6
+         << setw(9) << pixels / (best / 1e3)
+         << setw(9) << single / best << endl;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  unsigned int size = 256;
+  if (argc > 1) {
+    size = strtoul(argv[1], NULL, 10);
+  }
+  srand(221);
+
+  vector<BenchImage> images;
+  images.push_back(LoadImage("Canada", 80, 80, 0.01));
+  images.push_back(LoadImage("cloud", 79, 75, 0.05));
+  images.push_back(LoadImage("leaf", 50, 50, 0.08));
+  images.push_back(LoadImage("mooncake", 120, 75, 0.008));
+  images.push_back(LoadImage("strawberry", 11, 12, 0.05));
+  images.push_back(FlatImage(size));
+  images.push_back(MazeImage(size));
+
+  PNG tile;
+  tile.readFromFile(TILEIMAGE);
+
+  const char* kinds[] = { "solid", "negative", "imagetile", "censor", "rainbow" };
+  const char* orders[] = { "dfs", "bfs" };
+  int frameFreqs[] = { 100, 1000, 10000 };
+  double clockNanos = ClockNanos();
+
+  cout << "synthetic image size: " << size << " x " << size
+       << ", clock read: " << fixed << setprecision(1) << clockNanos << " ns" << endl;
+  PrintHeader();
+  for (size_t i = 0; i < images.size(); i++) {
+    for (const char* kind : kinds) {
+      for (const char* order : orders) {
+        for (int frameFreq : frameFreqs) {
+          BenchResult result = BenchFill(images[i], tile, kind, order, frameFreq, clockNanos);
+          PrintResult(images[i].name, kind, order, frameFreq, result);
+        }
+      }
+    }
+  }
+  remove(BENCHGIF);
+
+  // large enough that exploration, not thread start-up, dominates
+  BenchImage cells = CellImage(4 * size);
+  BenchSeeds(cells);
+  return 0;
+}
@@ -0,0 +1,137 @@
+/*
+* File:        benchStackQueue.cpp
+* Description: Benchmark comparing the circular-buffer Queue against the
+*              original two-stack StackQueue, on the item types used by the
+*              fills and with access patterns like those of a BFS fill.
+*
+*              For each workload, prints the mean time per operation and the
+*              slowest single Remove, which shows the bursts of copying the
+*              two-stack design does when its output stack runs dry.
+*
+* Date:        2026-10-19
+*
+*/
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+#include "pixelpoint.h"
+#include "queue.h"
+#include "stackqueue.h"
+
+using namespace std;
+
+// measurements for one workload on one structure
+struct BenchResult {
+  double nanosPerOp;    // mean time per Add or Remove
+  double maxRemoveNanos; // slowest single Remove
+};
+
+/*
+*  Makes the i-th item added in a workload.
+*/
+template <class T> T MakeItem(size_t i);
+
+template <> uint32_t MakeItem<uint32_t>(size_t i) {
+  return (uint32_t) i;
+}
+
+template <> PixelPoint MakeItem<PixelPoint>(size_t i) {
+  return PixelPoint(i % 1024, i / 1024, HSLAPixel(i % 360, 0.5, 0.5));
+}
+
+/*
+*  Times a single Remove, updating the slowest seen so far.
+*/
+template <class T, class OS>
+T TimedRemove(OS& os, double& maxRemoveNanos) {
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  T item = os.Remove();
+  double nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+  if (nanos > maxRemoveNanos) {
+    maxRemoveNanos = nanos;
+  }
+  return item;
+}
+
+/*
+*  Adds n items, then removes them all.
+*/
+template <class T, class OS>
+BenchResult BenchFillDrain(size_t n) {
+  OS os;
+  BenchResult result = { 0, 0 };
+  volatile size_t checksum = 0;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (size_t i = 0; i < n; i++) {
+    os.Add(MakeItem<T>(i));
+  }
+  while (!os.IsEmpty()) {
+    T item = TimedRemove<T>(os, result.maxRemoveNanos);
+    checksum = checksum + sizeof(item);
+  }
+  double nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+  result.nanosPerOp = nanos / (2 * n);
+  return result;
+}
+
+/*
+*  Imitates a BFS frontier: each Remove is followed by one or two Adds,
+*  alternately, until n items have been added and the queue has drained.
+*/
+template <class T, class OS>
+BenchResult BenchFrontier(size_t n) {
+  OS os;
+  BenchResult result = { 0, 0 };
+  volatile size_t checksum = 0;
+  size_t added = 0;
+  size_t ops = 0;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  os.Add(MakeItem<T>(added++));
+  ops++;
+  while (!os.IsEmpty()) {
+    T item = TimedRemove<T>(os, result.maxRemoveNanos);
+    checksum = checksum + sizeof(item);
+    ops++;
+    int children = 1 + ops % 2;
+    for (int c = 0; c < children && added < n; c++) {
+      os.Add(MakeItem<T>(added++));
+      ops++;
+    }
+  }
+  double nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+  result.nanosPerOp = nanos / ops;
+  return result;
+}
+
+void PrintResult(const string& workload, const string& structure, const BenchResult& result) {
+  cout << left << setw(28) << workload << setw(12) << structure << right
+       << setw(12) << fixed << setprecision(2) << result.nanosPerOp
+       << setw(16) << setprecision(0) << result.maxRemoveNanos << endl;
+}
+
+template <class T>
+void BenchType(const string& type, size_t n) {
+  PrintResult("fill/drain " + type, "Queue", BenchFillDrain<T, Queue<T> >(n));
+  PrintResult("fill/drain " + type, "StackQueue", BenchFillDrain<T, StackQueue<T> >(n));
+  PrintResult("frontier " + type, "Queue", BenchFrontier<T, Queue<T> >(n));
+  PrintResult("frontier " + type, "StackQueue", BenchFrontier<T, StackQueue<T> >(n));
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = 1000000;
+  if (argc > 1) {
+    n = strtoul(argv[1], NULL, 10);
+  }
+
+  cout << "items per workload: " << n << endl;
+  cout << left << setw(28) << "workload" << setw(12) << "structure" << right
+       << setw(12) << "ns/op" << setw(16) << "max remove ns" << endl;
+  BenchType<uint32_t>("uint32_t", n);
+  BenchType<PixelPoint>("PixelPoint", n);
+  return 0;
+}
@@ -5,8 +5,11 @@
 */
 
 #include "censorColorPicker.h"
+#include "pixelspan.h"
 
+#include <algorithm>
 #include <math.h> // gives access to sqrt function
+#include <stdint.h>
 
 /*
 *  Useful function for computing the Euclidean distance between two PixelPoints
@@ -25,52 +28,122 @@ double PointDistance(PixelPoint a, PixelPoint b) {
 }
 
 CensorColorPicker::CensorColorPicker(unsigned int b_width, PixelPoint ctr, unsigned int rad, PNG& inputimage)
+{
+  initialize(b_width, ctr, rad, ShareImage(inputimage), nullptr, false);
+}
+
+CensorColorPicker::CensorColorPicker(unsigned int b_width, PixelPoint ctr, unsigned int rad, PNG& inputimage,
+                                     shared_ptr<const IntegralImage> sums, bool lazy)
+{
+  initialize(b_width, ctr, rad, ShareImage(inputimage), sums, lazy);
+}
+
+CensorColorPicker::CensorColorPicker(unsigned int b_width, PixelPoint ctr, unsigned int rad, ImageHandle inputimage,
+                                     shared_ptr<const IntegralImage> sums, bool lazy)
+{
+  initialize(b_width, ctr, rad, inputimage, sums, lazy);
+}
+
+void CensorColorPicker::initialize(unsigned int b_width, PixelPoint ctr, unsigned int rad, ImageHandle inputimage,
+                                   shared_ptr<const IntegralImage> sums, bool lazy)
 {
   blockwidth = b_width;
   center = ctr;
   radius = rad;
   img = inputimage;
-  blockyimg.resize(ceil(img.width() / (double) blockwidth), ceil(img.height() / (double) blockwidth));
-
-  for (double cornerx=0; cornerx<img.width(); cornerx+=blockwidth) {
-    for (double cornery=0; cornery<img.height(); cornery+=blockwidth) {
-      double sumH = 0;
-      double sumS = 0;
-      double sumL = 0;
-      double sumA = 0;
-
-      int totalPixels = 0;
-      for (unsigned int x=0; x<blockwidth; x++) {
-        if (cornerx+x >= img.width()) {
-          break; // if x runs off image, break loop
-        }
-        for (unsigned int y=0; y<blockwidth; y++) {
-          if (cornery+y >= img.height()) {
-            break; // if y runs off image, break loop
-          }
-          // taking the sum of each hsla field in block
-          HSLAPixel* pixel = img.getPixel(cornerx+x, cornery+y);
-          sumH += pixel->h;
-          sumS += pixel->s;
-          sumL += pixel->l;
-          sumA += pixel->a;
-          totalPixels++;
-        }
-      }
-      
-      HSLAPixel average = HSLAPixel(sumH / totalPixels, sumS / totalPixels, sumL / totalPixels, sumA / totalPixels);
-      *blockyimg.getPixel(floor(cornerx / blockwidth), floor(cornery / blockwidth)) = average;
+  // a table summed from an image of another size would read out of bounds
+  if (sums && sums->Width() == img->width() && sums->Height() == img->height())
+    integral = sums;
+  else
+    integral = make_shared<IntegralImage>(*img);
+  unsigned int blocksx = (img->width() + blockwidth - 1) / blockwidth;
+  unsigned int blocksy = (img->height() + blockwidth - 1) / blockwidth;
+  blockyimg.resize(blocksx, blocksy);
+
+  if (lazy) {
+    computed.assign((size_t) blocksx * blocksy, false);
+    return;
+  }
+  for (unsigned int by = 0; by < blocksy; by++) {
+    for (unsigned int bx = 0; bx < blocksx; bx++) {
+      computeBlock(bx, by);
     }
   }
 }
 
+/*
+*  Sets a pixel of blockyimg to the average colour of its block of img.
+*/
+void CensorColorPicker::computeBlock(unsigned int bx, unsigned int by)
+{
+  *blockyimg.getPixel(bx, by) = integral->Average(bx * blockwidth, by * blockwidth,
+                                                  (bx + 1) * blockwidth, (by + 1) * blockwidth);
+}
+
+/*
+*  Returns the pixel of blockyimg holding a block's average colour, first
+*  computing it if the picker is lazy and has not needed it before.
+*/
+HSLAPixel* CensorColorPicker::blockColor(unsigned int bx, unsigned int by)
+{
+  if (!computed.empty() && !computed[(size_t) by * blockyimg.width() + bx]) {
+    computeBlock(bx, by);
+    computed[(size_t) by * blockyimg.width() + bx] = true;
+  }
+  return blockyimg.getPixel(bx, by);
+}
+
 HSLAPixel CensorColorPicker::operator()(PixelPoint p)
 {
   HSLAPixel* pixel;
-  if (PointDistance(p, center) <= radius) {
-    pixel = blockyimg.getPixel(floor(p.x / (double) blockwidth), floor(p.y / (double) blockwidth));
+  if (Covers(p)) {
+    // points off the image use its last block, as getPixel would
+    unsigned int bx = min(p.x / blockwidth, blockyimg.width() - 1);
+    unsigned int by = min(p.y / blockwidth, blockyimg.height() - 1);
+    pixel = blockColor(bx, by);
   } else {
-    pixel = img.getPixel(p.x, p.y);
+    pixel = img->getPixel(p.x, p.y);
   }
   return *pixel;
 }
+
+void CensorColorPicker::PickSpan(unsigned int x, unsigned int y, unsigned int count,
+                                 const HSLAPixel* /* originals */, HSLAPixel* out)
+{
+  uint64_t end = (uint64_t) x + count;
+
+  // [inleft, inright) is the part of the run inside the circle. A point is
+  // inside when dx^2 + dy^2 <= radius^2, i.e. when |dx| <= half below.
+  uint64_t inleft = end;
+  uint64_t inright = end;
+  uint64_t dy = y > center.y ? y - center.y : center.y - y;
+  uint64_t r2 = (uint64_t) radius * radius;
+  if (dy * dy <= r2) {
+    uint64_t rem = r2 - dy * dy;
+    uint64_t half = (uint64_t) sqrt((double) rem);
+    while (half * half > rem) {
+      half--;
+    }
+    while ((half + 1) * (half + 1) <= rem) {
+      half++;
+    }
+    inleft = center.x > half ? center.x - half : 0;
+    inright = (uint64_t) center.x + half + 1;
+    inleft = min(max(inleft, (uint64_t) x), end);
+    inright = max(min(inright, end), inleft);
+  }
+
+  const HSLAPixel* row = img->getPixel(0, y);
+  CopySpan(out, row + x, inleft - x);
+
+  unsigned int by = min(y / blockwidth, blockyimg.height() - 1);
+  for (uint64_t px = inleft; px < inright;) {
+    unsigned int bx = min((unsigned int) px / blockwidth, blockyimg.width() - 1);
+    uint64_t next = bx + 1 < blockyimg.width() ? (uint64_t) (bx + 1) * blockwidth : inright;
+    next = min(next, inright);
+    FillSpan(out + (px - x), next - px, *blockColor(bx, by));
+    px = next;
+  }
+
+  CopySpan(out + (inright - x), row + inright, end - inright);
+}
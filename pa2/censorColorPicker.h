@@ -6,7 +6,13 @@
 #ifndef _CENSORCOLORPICKER_H_
 #define _CENSORCOLORPICKER_H_
 
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
 #include "colorPicker.h"
+#include "imagehandle.h"
+#include "integralimage.h"
 #include "pixelpoint.h"
 
 /*
@@ -14,7 +20,7 @@
 *  given a point using a mosaic block pattern.
 *
 */
-class CensorColorPicker : public ColorPicker
+class CensorColorPicker final : public ColorPicker
 {
   public:
     /*
@@ -27,6 +33,34 @@ class CensorColorPicker : public ColorPicker
     */
     CensorColorPicker(unsigned int b_width, PixelPoint ctr, unsigned int rad, PNG& inputimage);
 
+    /*
+    *  Constructs a new CensorColorPicker whose block averages are looked up
+    *  in a summed-area table of the input image, which can be shared by any
+    *  number of pickers with different block widths or regions, so that
+    *  each picker costs O(number of blocks) rather than O(W x H) to build.
+    *
+    *  PARAM: b_width, ctr, rad, inputimage - as above
+    *  PARAM: sums - summed-area table of inputimage; one of a different
+    *               size is ignored and a fresh table built instead
+    *  PARAM: lazy - if true, each block's average is computed the first time
+    *                a pixel in it is picked inside the mosaic area, so only
+    *                blocks intersecting the circle are ever computed
+    */
+    CensorColorPicker(unsigned int b_width, PixelPoint ctr, unsigned int rad, PNG& inputimage,
+                      shared_ptr<const IntegralImage> sums, bool lazy = false);
+
+    /*
+    *  Constructs a new CensorColorPicker that shares inputimage instead of
+    *  copying it.
+    *
+    *  PARAM: b_width, ctr, rad, lazy - as above
+    *  PARAM: inputimage - handle to the original input image
+    *  PARAM: sums - summed-area table of inputimage, or null to build one;
+    *               one of a different size is ignored like null
+    */
+    CensorColorPicker(unsigned int b_width, PixelPoint ctr, unsigned int rad, ImageHandle inputimage,
+                      shared_ptr<const IntegralImage> sums = nullptr, bool lazy = false);
+
     /*
     *  Picks the color for pixel (x, y). There is a circular region in which the fill is "active".
     *  Outside that region, it simply returns the colour from the original image. Inside the active
@@ -53,12 +87,41 @@ class CensorColorPicker : public ColorPicker
     */
     virtual HSLAPixel operator()(PixelPoint p);
 
+    /*
+    *  Returns true if p lies in the circular region that is mosaicked.
+    *  Outside it, the picker returns the original image's colour, so a
+    *  LayeredColorPicker can show another picker there instead.
+    */
+    bool Covers(PixelPoint p) const {
+      // the distance is within radius exactly when its square is within
+      // radius squared, so no sqrt is needed
+      uint64_t dx = p.x > center.x ? p.x - center.x : center.x - p.x;
+      uint64_t dy = p.y > center.y ? p.y - center.y : center.y - p.y;
+      return dx * dx + dy * dy <= (uint64_t) radius * radius;
+    }
+
+    /*
+    *  Picks the colors for a run of pixels by working out where the run
+    *  crosses the circular region once, then copying the original image
+    *  outside it and filling each block's average colour inside it.
+    */
+    virtual void PickSpan(unsigned int x, unsigned int y, unsigned int count,
+                          const HSLAPixel* originals, HSLAPixel* out);
+
   private:
     unsigned int blockwidth; // width of a mosaic block in pixels.
     PixelPoint center;       // middle/center point of mosaic area
     unsigned int radius;     // maximum pixel distance away from center where the mosaic color will be applied
-    PNG img;                 // Original image used in flood fill algorithm
+    ImageHandle img;         // Original image used in flood fill algorithm
     PNG blockyimg;           // fully block-ified version of the original image, computed once at creation time
+                             // (or block by block, when lazy)
+    shared_ptr<const IntegralImage> integral; // summed-area table of img
+    vector<bool> computed;   // for a lazy picker, whether each block of blockyimg has been computed
+
+    void initialize(unsigned int b_width, PixelPoint ctr, unsigned int rad, ImageHandle inputimage,
+                    shared_ptr<const IntegralImage> sums, bool lazy);
+    void computeBlock(unsigned int bx, unsigned int by);
+    HSLAPixel* blockColor(unsigned int bx, unsigned int by);
 };
 
 #endif
@@ -43,6 +43,44 @@ class ColorPicker
     *  RETURN: The color chosen for (p).
     */
     virtual HSLAPixel operator()(PixelPoint p) = 0;
+
+    /*
+    *  Picks the colors for a horizontal run of pixels: (x, y), (x + 1, y),
+    *  ..., (x + count - 1, y), writing them to out[0], ..., out[count - 1].
+    *  This lets a fill colour a whole run with one virtual call.
+    *
+    *  The default calls operator() for each pixel in turn. Pickers that can
+    *  colour a run more cheaply override it, and must pick the same colors
+    *  operator() would.
+    *
+    *  PARAM: originals - the current colors of the run's pixels, passed to
+    *                     operator() as each PixelPoint's color
+    *  PARAM: out - where to write the colors; may be the same array as originals
+    *  PRE:   the run lies within the image being filled
+    */
+    virtual void PickSpan(unsigned int x, unsigned int y, unsigned int count,
+                          const HSLAPixel* originals, HSLAPixel* out) {
+      for (unsigned int i = 0; i < count; i++) {
+        out[i] = (*this)(PixelPoint(x + i, y, originals[i]));
+      }
+    }
 };
 
+/*
+*  Picks the color for p with picker, calling Picker's own operator()
+*  directly rather than through the vtable when the picker's type is known
+*  at compile time, as in the templated fills and LayeredColorPicker.
+*/
+template <class Picker>
+inline HSLAPixel PickColor(Picker& picker, PixelPoint p) {
+  return picker.Picker::operator()(p);
+}
+
+/*
+*  Picks the color for p with a picker whose type is only known at run time.
+*/
+inline HSLAPixel PickColor(ColorPicker& picker, PixelPoint p) {
+  return picker(p);
+}
+
 #endif
@@ -0,0 +1,47 @@
+/*
+*  File:        colorcoordinates.h
+*  Description: The coordinates HSLAPixel::dist measures colour distances
+*               between, so that distances can be computed once per pixel
+*               rather than once per comparison.
+*
+*/
+
+#ifndef _COLORCOORDINATES_H_
+#define _COLORCOORDINATES_H_
+
+#include <math.h>
+
+#include "cs221util/HSLAPixel.h"
+
+using namespace cs221util;
+
+// the value of pi HSLAPixel::dist converts degrees with
+const double DISTPI = 3.14159265;
+
+/*
+*  A colour as the point HSLAPixel::dist places it at. The coordinates are
+*  computed with the same expressions as dist, so CoordinateDistance agrees
+*  with dist bit for bit.
+*/
+struct ColorCoordinates {
+  double x; // sin(h) * s * l
+  double y; // cos(h) * s * l
+  double l; // l
+};
+
+inline ColorCoordinates Coordinates(HSLAPixel const& p) {
+  ColorCoordinates c;
+  c.x = sin(p.h * DISTPI / 180) * p.s * p.l;
+  c.y = cos(p.h * DISTPI / 180) * p.s * p.l;
+  c.l = p.l;
+  return c;
+}
+
+/*
+*  Returns a.dist(b) for the colours a and b are the coordinates of.
+*/
+inline double CoordinateDistance(ColorCoordinates const& a, ColorCoordinates const& b) {
+  return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.l - b.l) * (a.l - b.l);
+}
+
+#endif
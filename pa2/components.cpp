@@ -0,0 +1,276 @@
+/*
+*  File:        components.cpp
+*  Description: Implementation of the ComponentLabels class.
+*
+*/
+
+#include "components.h"
+
+#include <algorithm>
+#include <thread>
+
+// fewest rows given to each labelling thread, so small images use one thread
+#define MINSTRIPROWS 32
+
+ComponentLabels::ComponentLabels(const PNG& img, double tolerance, unsigned int numthreads)
+{
+  width = img.width();
+  height = img.height();
+  labels.resize((size_t) width * height);
+  if (width == 0 || height == 0) {
+    return;
+  }
+
+  if (numthreads == 0) {
+    numthreads = max(thread::hardware_concurrency(), 1u);
+  }
+  numthreads = min(numthreads, max(height / MINSTRIPROWS, 1u));
+
+  // pass 1: runs, merged with the row above, within each strip
+  vector<Strip> strips(numthreads);
+  unsigned int rowsperstrip = (height + numthreads - 1) / numthreads;
+  for (unsigned int i = 0; i < numthreads; i++) {
+    strips[i].top = min(i * rowsperstrip, height);
+    strips[i].bottom = min(strips[i].top + rowsperstrip, height);
+  }
+  vector<thread> workers;
+  for (unsigned int i = 1; i < numthreads; i++) {
+    workers.push_back(thread(&ComponentLabels::buildStrip, this, cref(img), tolerance, ref(strips[i])));
+  }
+  buildStrip(img, tolerance, strips[0]);
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+  workers.clear();
+
+  // pass 2: one union-find over every strip's runs, in row-major order
+  vector<size_t> offsets(numthreads + 1, 0);
+  for (unsigned int i = 0; i < numthreads; i++) {
+    offsets[i + 1] = offsets[i] + strips[i].runs.size();
+  }
+  vector<uint32_t> parents(offsets[numthreads]);
+  for (unsigned int i = 0; i < numthreads; i++) {
+    for (size_t r = 0; r < strips[i].parents.size(); r++) {
+      parents[offsets[i] + r] = strips[i].parents[r] + offsets[i];
+    }
+  }
+
+  // merge the last row of each strip with the first row of the next
+  vector<ColorCoordinates> above, below;
+  for (unsigned int i = 0; i + 1 < numthreads; i++) {
+    Strip const& upper = strips[i];
+    Strip const& lower = strips[i + 1];
+    if (upper.runs.empty() || lower.runs.empty()) {
+      continue;
+    }
+    uint32_t lastrow = upper.rowstarts[upper.rowstarts.size() - 2];
+    rowCoordinates(img, upper.bottom - 1, above);
+    rowCoordinates(img, lower.top, below);
+    mergeRows(above, below, tolerance, parents, &upper.runs[lastrow], offsets[i] + lastrow,
+              &lower.runs[0], offsets[i + 1]);
+  }
+
+  // every root is its region's first run in row-major order, so labelling
+  // the roots in run order labels regions by their first pixels
+  vector<uint32_t> runlabels(parents.size());
+  for (unsigned int i = 0; i < numthreads; i++) {
+    for (size_t r = 0; r < strips[i].runs.size(); r++) {
+      uint32_t index = offsets[i] + r;
+      uint32_t root = find(parents, index);
+      Run const& run = strips[i].runs[r];
+      if (root == index) {
+        runlabels[index] = regions.size();
+        RegionStats stats;
+        stats.area = 0;
+        stats.left = run.left;
+        stats.top = run.y;
+        stats.right = run.right;
+        stats.bottom = run.y;
+        stats.mean = HSLAPixel(0, 0, 0, 0);
+        regions.push_back(stats);
+      } else {
+        runlabels[index] = runlabels[root];
+      }
+
+      // the mean's fields hold the channel sums until every run is counted
+      RegionStats& stats = regions[runlabels[index]];
+      stats.area += run.right - run.left + 1;
+      stats.left = min(stats.left, run.left);
+      stats.right = max(stats.right, run.right);
+      stats.bottom = run.y;
+      stats.mean.h += run.sums[0];
+      stats.mean.s += run.sums[1];
+      stats.mean.l += run.sums[2];
+      stats.mean.a += run.sums[3];
+    }
+  }
+  for (size_t i = 0; i < regions.size(); i++) {
+    RegionStats& stats = regions[i];
+    stats.mean = HSLAPixel(stats.mean.h / stats.area, stats.mean.s / stats.area,
+                           stats.mean.l / stats.area, stats.mean.a / stats.area);
+  }
+
+  for (unsigned int i = 1; i < numthreads; i++) {
+    workers.push_back(thread(&ComponentLabels::labelStrip, this, cref(strips[i]), cref(runlabels), offsets[i]));
+  }
+  labelStrip(strips[0], runlabels, 0);
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+}
+
+/*
+*  Computes the coordinates of every pixel of row y of img.
+*/
+void ComponentLabels::rowCoordinates(const PNG& img, unsigned int y, vector<ColorCoordinates>& coordinates) const
+{
+  coordinates.resize(width);
+  const HSLAPixel* row = img.getPixel(0, y);
+  for (unsigned int x = 0; x < width; x++) {
+    coordinates[x] = Coordinates(row[x]);
+  }
+}
+
+/*
+*  Divides the rows of a strip into runs, merging each row's runs with the
+*  runs above them.
+*/
+void ComponentLabels::buildStrip(const PNG& img, double tolerance, Strip& strip) const
+{
+  vector<ColorCoordinates> above, below;
+  for (unsigned int y = strip.top; y < strip.bottom; y++) {
+    const HSLAPixel* row = img.getPixel(0, y);
+    rowCoordinates(img, y, below);
+    uint32_t rowstart = strip.runs.size();
+    strip.rowstarts.push_back(rowstart);
+
+    for (unsigned int x = 0; x < width; x++) {
+      if (x == 0 || CoordinateDistance(below[x - 1], below[x]) > tolerance) {
+        Run run;
+        run.y = y;
+        run.left = x;
+        run.right = x;
+        run.sums[0] = run.sums[1] = run.sums[2] = run.sums[3] = 0;
+        strip.parents.push_back(strip.runs.size());
+        strip.runs.push_back(run);
+      }
+      Run& run = strip.runs.back();
+      run.right = x;
+      run.sums[0] += row[x].h;
+      run.sums[1] += row[x].s;
+      run.sums[2] += row[x].l;
+      run.sums[3] += row[x].a;
+    }
+
+    if (y > strip.top) {
+      uint32_t abovestart = strip.rowstarts[strip.rowstarts.size() - 2];
+      mergeRows(above, below, tolerance, strip.parents, &strip.runs[abovestart], abovestart,
+                &strip.runs[rowstart], rowstart);
+    }
+    swap(above, below);
+  }
+  strip.rowstarts.push_back(strip.runs.size());
+}
+
+/*
+*  Merges the runs of two adjacent rows wherever a pixel is within tolerance
+*  of the pixel below it. The runs of each row cover it from left to right;
+*  abovefirst and belowfirst are the union-find indices of their first runs.
+*/
+void ComponentLabels::mergeRows(vector<ColorCoordinates> const& above, vector<ColorCoordinates> const& below,
+                                double tolerance, vector<uint32_t>& parents,
+                                const Run* aboveruns, uint32_t abovefirst,
+                                const Run* belowruns, uint32_t belowfirst) const
+{
+  uint32_t a = 0;
+  uint32_t b = 0;
+  for (unsigned int x = 0; x < width; x++) {
+    if (x > aboveruns[a].right) {
+      a++;
+    }
+    if (x > belowruns[b].right) {
+      b++;
+    }
+    // skip the distance when the runs are already merged
+    if (find(parents, abovefirst + a) != find(parents, belowfirst + b) &&
+        CoordinateDistance(above[x], below[x]) <= tolerance) {
+      unite(parents, abovefirst + a, belowfirst + b);
+    }
+  }
+}
+
+/*
+*  Writes the label of every pixel in a strip's runs.
+*  PARAM: first - union-find index of the strip's first run
+*/
+void ComponentLabels::labelStrip(Strip const& strip, vector<uint32_t> const& runlabels, size_t first)
+{
+  for (size_t r = 0; r < strip.runs.size(); r++) {
+    Run const& run = strip.runs[r];
+    uint32_t* row = &labels[(size_t) run.y * width];
+    fill(row + run.left, row + run.right + 1, runlabels[first + r]);
+  }
+}
+
+/*
+*  Returns the root of i's set, halving the path to it along the way.
+*/
+uint32_t ComponentLabels::find(vector<uint32_t>& parents, uint32_t i)
+{
+  while (parents[i] != i) {
+    parents[i] = parents[parents[i]];
+    i = parents[i];
+  }
+  return i;
+}
+
+/*
+*  Merges the sets of a and b. The lower root becomes the root of both, so
+*  every set's root is its first run.
+*/
+void ComponentLabels::unite(vector<uint32_t>& parents, uint32_t a, uint32_t b)
+{
+  a = find(parents, a);
+  b = find(parents, b);
+  if (a < b) {
+    parents[b] = a;
+  } else if (b < a) {
+    parents[a] = b;
+  }
+}
+
+vector<uint32_t> const& ComponentLabels::Labels() const
+{
+  return labels;
+}
+
+size_t ComponentLabels::RegionCount() const
+{
+  return regions.size();
+}
+
+RegionStats const& ComponentLabels::Region(uint32_t label) const
+{
+  return regions[label];
+}
+
+PNG ComponentLabels::MeanImage() const
+{
+  PNG img(width, height);
+  for (unsigned int y = 0; y < height; y++) {
+    for (unsigned int x = 0; x < width; x++) {
+      *img.getPixel(x, y) = regions[Label(x, y)].mean;
+    }
+  }
+  return img;
+}
+
+unsigned int ComponentLabels::Width() const
+{
+  return width;
+}
+
+unsigned int ComponentLabels::Height() const
+{
+  return height;
+}
@@ -0,0 +1,137 @@
+/*
+*  File:        components.h
+*  Description: Definition of a ComponentLabels class, which labels every
+*               connected region of an image at once.
+*
+*/
+
+#ifndef _COMPONENTS_H_
+#define _COMPONENTS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "cs221util/HSLAPixel.h"
+#include "cs221util/PNG.h"
+
+#include "colorcoordinates.h"
+
+using namespace std;
+using namespace cs221util;
+
+/*
+*  Statistics of one labelled region.
+*/
+struct RegionStats {
+  size_t area;         // number of pixels in the region
+  unsigned int left;   // bounding box of the region, inclusive
+  unsigned int top;
+  unsigned int right;
+  unsigned int bottom;
+  HSLAPixel mean;      // arithmetic mean of each H/S/L/A channel over the region
+};
+
+/*
+*  ComponentLabels divides a whole image into connected regions in one
+*  pass, rather than filling one seed at a time. Two neighbouring pixels
+*  (up/down/left/right) are in the same region if their colours are within
+*  tolerance of each other by HSLAPixel::dist; a region is everything
+*  connected by such steps. (A seeded fill instead compares every pixel with
+*  the seed's colour, so a fill's region can be smaller than the component
+*  containing its seed.)
+*
+*  Regions are labelled 0, 1, 2, ... in the order their first pixels appear
+*  in row-major order, so the labels do not depend on the number of threads.
+*
+*  The image is labelled by run-based union-find in two passes:
+*    1. The rows are split into strips, one per thread. Each thread divides
+*       its rows into runs of connected pixels, and merges every run with
+*       the runs it connects to in the row above.
+*    2. The runs either side of each strip boundary are merged, every run
+*       is given its region's label, and the label image and statistics are
+*       filled in from the runs.
+*/
+class ComponentLabels {
+  public:
+    /*
+    *  Labels the regions of img.
+    *  PARAM: img - image to label
+    *  PARAM: tolerance - greatest colour distance between connected neighbours
+    *  PARAM: numthreads - number of threads to label with, or 0 for one per
+    *                      hardware thread
+    *  PRE:   img has fewer than 2^32 pixels
+    */
+    ComponentLabels(const PNG& img, double tolerance, unsigned int numthreads = 0);
+
+    /*
+    *  Returns the label of pixel (x, y).
+    *  PRE: (x, y) lies within the image.
+    */
+    uint32_t Label(unsigned int x, unsigned int y) const {
+      return labels[(size_t) y * width + x];
+    }
+
+    /*
+    *  Returns the label of every pixel, in row-major order.
+    */
+    vector<uint32_t> const& Labels() const;
+
+    /*
+    *  Returns the number of regions.
+    */
+    size_t RegionCount() const;
+
+    /*
+    *  Returns the statistics of the region with the given label.
+    *  PRE: label < RegionCount().
+    */
+    RegionStats const& Region(uint32_t label) const;
+
+    /*
+    *  Returns an image in which every pixel is its region's mean colour.
+    */
+    PNG MeanImage() const;
+
+    /*
+    *  Returns the dimensions of the labelled image.
+    */
+    unsigned int Width() const;
+    unsigned int Height() const;
+
+  private:
+    // a maximal horizontal run of connected pixels in one row
+    struct Run {
+      unsigned int y;
+      unsigned int left;
+      unsigned int right;  // inclusive
+      double sums[4];      // sums of the H/S/L/A channels over the run
+    };
+
+    // the runs of one strip of rows, and their union-find parents (as
+    // indices into the strip's runs while the strip is being built)
+    struct Strip {
+      unsigned int top;
+      unsigned int bottom; // exclusive
+      vector<Run> runs;
+      vector<uint32_t> parents;
+      vector<uint32_t> rowstarts; // index of the first run of each row, and one past the last
+    };
+
+    unsigned int width;
+    unsigned int height;
+    vector<uint32_t> labels;      // label of every pixel, row-major
+    vector<RegionStats> regions;  // statistics of every region, by label
+
+    void buildStrip(const PNG& img, double tolerance, Strip& strip) const;
+    void rowCoordinates(const PNG& img, unsigned int y, vector<ColorCoordinates>& coordinates) const;
+    void mergeRows(vector<ColorCoordinates> const& above, vector<ColorCoordinates> const& below,
+                   double tolerance, vector<uint32_t>& parents,
+                   const Run* aboveruns, uint32_t abovefirst, const Run* belowruns, uint32_t belowfirst) const;
+    void labelStrip(Strip const& strip, vector<uint32_t> const& runlabels, size_t first);
+
+    static uint32_t find(vector<uint32_t>& parents, uint32_t i);
+    static void unite(vector<uint32_t>& parents, uint32_t a, uint32_t b);
+};
+
+#endif
@@ -30,6 +30,14 @@ animation filler::FillDFS(FillerConfig& config) {
   return Fill<Stack>(config); // REPLACE THIS STUB
 }
 
+template <class Picker> animation filler::FillBFS(FillerConfig& config, Picker& picker) {
+  return Fill<Queue>(config, picker);
+}
+
+template <class Picker> animation filler::FillDFS(FillerConfig& config, Picker& picker) {
+  return Fill<Stack>(config, picker);
+}
+
 /*
 *  Run a flood fill on an image starting at the seed point
 *
@@ -37,6 +45,20 @@ animation filler::FillDFS(FillerConfig& config) {
 *  RETURN: animation object illustrating progression of flood fill algorithm
 */
 template <template <class T> class OrderingStructure> animation filler::Fill(FillerConfig& config)
+{
+  return Fill<OrderingStructure, ColorPicker>(config, *config.picker);
+}
+
+/*
+*  Run a flood fill on an image starting at the seed point, colouring it
+*  with a picker whose type is known at compile time.
+*
+*  PARAM:  config - FillerConfig struct with data for flood fill of image
+*  PARAM:  picker - picker used to fill the region
+*  RETURN: animation object illustrating progression of flood fill algorithm
+*/
+template <template <class T> class OrderingStructure, class Picker>
+animation filler::Fill(FillerConfig& config, Picker& picker)
 {
   /*
   * You need to implement this function!
@@ -99,61 +121,460 @@ template <template <class T> class OrderingStructure> animation filler::Fill(Fil
 
   int framecount = 0; // increment after processing one pixel; used for producing animation frames (step 3 above)
   animation anim;
-  OrderingStructure<PixelPoint> os;
+  startAnimation(config, anim);
 
-  // complete your implementation below
-  // HINT: you will likely want to declare some kind of structure to track
-  //       which pixels have already been visited
+  // Work items are packed into 32 bits (see packItem): the pixel's index in
+  // the image, and the order in which its neighbours are to be examined.
+  // That order only depends on the pixel's original colour, which is about
+  // to be overwritten by the picker, so it is worked out when the item is
+  // added instead of carrying the colour through the ordering structure.
+  OrderingStructure<uint32_t> os;
+  PixelBitmap visited(config.img.width(), config.img.height());
+  assert((uint64_t) config.img.width() * config.img.height() <= MAXITEMINDEX);
 
-  vector<vector<PixelPoint>> visited(config.img.width(),
-    vector<PixelPoint>(config.img.height(), PixelPoint(-1,-1, HSLAPixel())));
+  const ToleranceMask* mask = sharedMask(config);
 
-  config.neighbourorder.SetReferenceColor(config.seedpoint.color);
-  applyPicker(config.seedpoint, config);
-  os.Add(config.seedpoint);
-  visited[config.seedpoint.x][config.seedpoint.y] = config.seedpoint;
+  visited.Set(config.seedpoint.x, config.seedpoint.y);
+  unsigned int order = neighbourOrder(config.seedpoint.x, config.seedpoint.y, config.seedpoint.color, visited, config);
+  applyPicker(config.seedpoint, picker, config, anim);
+  os.Add(packItem(config.seedpoint.x, config.seedpoint.y, order, config.img.width()));
 
   while(!os.IsEmpty()) {
-    PixelPoint curr = os.Remove();
-    config.neighbourorder.SetReferenceColor(curr.color);
-    visit(curr.x, curr.y-1, visited, config);
-    visit(curr.x, curr.y+1, visited, config);
-    visit(curr.x-1, curr.y, visited, config);
-    visit(curr.x+1, curr.y, visited, config);
-    
-    while (!config.neighbourorder.IsEmpty()) {
-      PixelPoint processing = config.neighbourorder.Remove();
-      applyPicker(processing, config);
-      os.Add(processing);
+    unsigned int x, y;
+    unpackItem(os.Remove(), config.img.width(), x, y, order);
+    unsigned char directions[4];
+    decodeOrder(order, directions);
+
+    for (int i = 0; i < 4; i++) {
+      unsigned int nx = x + NEIGHBOURDX[directions[i]];
+      unsigned int ny = y + NEIGHBOURDY[directions[i]];
+      // coordinates left of or above the image wrap around to large values
+      if (nx >= config.img.width() || ny >= config.img.height() || visited.Get(nx, ny)) {
+        continue;
+      }
+      visited.Set(nx, ny);
+      if (!inTolerance(nx, ny, config, mask)) {
+        continue;
+      }
+      HSLAPixel color = *config.img.getPixel(nx, ny);
+
+      order = neighbourOrder(nx, ny, color, visited, config);
+      applyPicker(PixelPoint(nx, ny, color), picker, config, anim);
+      os.Add(packItem(nx, ny, order, config.img.width()));
       framecount++;
       if (framecount % config.frameFreq == 0 && framecount != 0) {
-        anim.addFrame(config.img);
+        anim.endFrame();
+      }
+    }
+  }
+  anim.endFrame();
+  return anim;
+}
+
+/*
+*  Works out the order in which the neighbours of (x, y) should be examined
+*  once (x, y) is taken off the ordering structure: by minimum colour distance
+*  from color, with ties broken by minimum y, then minimum x, as determined by
+*  config.neighbourorder. Neighbours that are off the image or already visited
+*  are placed last, since they will be skipped anyway. Unvisited neighbours
+*  cannot change colour before they are visited, so the order stays valid.
+*
+*  PARAM:  color - original colour of (x, y)
+*  RETURN: the order, encoded by encodeOrder
+*/
+unsigned int filler::neighbourOrder(unsigned int x, unsigned int y, HSLAPixel color,
+                                    PixelBitmap& visited, FillerConfig& config) {
+  unsigned char directions[4];
+  bool placed[4] = { false, false, false, false };
+  int count = 0;
+
+  config.neighbourorder.SetReferenceColor(color);
+  for (int d = 0; d < 4; d++) {
+    unsigned int nx = x + NEIGHBOURDX[d];
+    unsigned int ny = y + NEIGHBOURDY[d];
+    if (nx < config.img.width() && ny < config.img.height() && !visited.Get(nx, ny)) {
+      config.neighbourorder.Insert(PixelPoint(nx, ny, *config.img.getPixel(nx, ny)));
+    }
+  }
+  while (!config.neighbourorder.IsEmpty()) {
+    PixelPoint p = config.neighbourorder.Remove();
+    int d = p.y < y ? 0 : p.y > y ? 1 : p.x < x ? 2 : 3;
+    directions[count++] = d;
+    placed[d] = true;
+  }
+  for (int d = 0; d < 4; d++) {
+    if (!placed[d]) {
+      directions[count++] = d;
+    }
+  }
+  return encodeOrder(directions);
+}
+
+/*
+*  Encodes an ordering of the four neighbour directions as its rank among the
+*  24 permutations (its Lehmer code), which fits in ORDERBITS bits.
+*/
+unsigned int filler::encodeOrder(const unsigned char directions[4]) {
+  unsigned int code = 0;
+  for (int i = 0; i < 4; i++) {
+    unsigned int smaller = 0;
+    for (int j = i + 1; j < 4; j++) {
+      if (directions[j] < directions[i]) {
+        smaller++;
+      }
+    }
+    code = code * (4 - i) + smaller;
+  }
+  return code;
+}
+
+/*
+*  Decodes an order produced by encodeOrder back into four neighbour directions.
+*/
+void filler::decodeOrder(unsigned int code, unsigned char directions[4]) {
+  unsigned int digits[4];
+  for (int i = 3; i >= 0; i--) {
+    digits[i] = code % (4 - i);
+    code /= (4 - i);
+  }
+  bool used[4] = { false, false, false, false };
+  for (int i = 0; i < 4; i++) {
+    unsigned int skip = digits[i];
+    int d = 0;
+    while (used[d] || skip > 0) {
+      if (!used[d]) {
+        skip--;
+      }
+      d++;
+    }
+    used[d] = true;
+    directions[i] = d;
+  }
+}
+
+/*
+*  Packs a pixel and its neighbour order into a single work item.
+*  PRE: y * width + x < MAXITEMINDEX, and order < 24.
+*/
+uint32_t filler::packItem(unsigned int x, unsigned int y, unsigned int order, unsigned int width) {
+  return (((uint32_t) y * width + x) << ORDERBITS) | order;
+}
+
+/*
+*  Unpacks a work item produced by packItem.
+*/
+void filler::unpackItem(uint32_t item, unsigned int width, unsigned int& x, unsigned int& y, unsigned int& order) {
+  uint32_t index = item >> ORDERBITS;
+  order = item & ((1 << ORDERBITS) - 1);
+  x = index % width;
+  y = index / width;
+}
+
+/*
+*  Prepares an animation to record the pixels a fill paints on config.img,
+*  streaming it to config.streamFile if one is given.
+*/
+void filler::startAnimation(FillerConfig& config, animation& anim) {
+  if (!config.streamFile.empty()) {
+    anim.stream(config.streamFile);
+  }
+  anim.setBase(config.img);
+}
+
+template <class Picker>
+void filler::applyPicker(PixelPoint const pixel, Picker& picker, FillerConfig& config, animation& anim) {
+  HSLAPixel* target = config.img.getPixel(pixel.x, pixel.y);
+  *target = PickColor(picker, pixel);
+  anim.recordPixel(pixel.x, pixel.y, *target);
+}
+
+/*
+*  Paints count pixels of row y starting at x with a single call to the
+*  picker, in place, and records them in the animation.
+*/
+void filler::paintSpan(unsigned int x, unsigned int y, unsigned int count, FillerConfig& config, animation& anim) {
+  HSLAPixel* row = config.img.getPixel(x, y);
+  config.picker->PickSpan(x, y, count, row, row);
+  for (unsigned int i = 0; i < count; i++) {
+    anim.recordPixel(x + i, y, row[i]);
+  }
+}
+
+/*
+*  Returns how many more pixels can be painted before the next frame is due.
+*/
+unsigned int filler::pixelsToFrame(int framecount, FillerConfig const& config) {
+  return config.frameFreq - framecount % config.frameFreq;
+}
+
+/*
+*  Run a scanline flood fill on an image starting at the seed point.
+*  Each step takes a span from the stack, finds the unvisited in-tolerance
+*  runs overlapping it, extends each run as far left and right as it goes,
+*  fills it, and pushes the spans directly above and below the run.
+*
+*  PARAM:  config - FillerConfig struct with data for flood fill of image
+*  RETURN: animation object illustrating progression of flood fill algorithm
+*/
+animation filler::FillScanline(FillerConfig& config) {
+  int framecount = 0;
+  animation anim;
+  startAnimation(config, anim);
+  PixelBitmap visited(config.img.width(), config.img.height());
+  const ToleranceMask* mask = sharedMask(config);
+  Stack<Span> spans;
+
+  Span seed = { config.seedpoint.x, config.seedpoint.x, config.seedpoint.y };
+  spans.Push(seed);
+
+  while (!spans.IsEmpty()) {
+    Span span = spans.Pop();
+    unsigned int x = span.left;
+    while (x <= span.right) {
+      if (visited.Get(x, span.y) || !inTolerance(x, span.y, config, mask)) {
+        x++;
+        continue;
       }
+
+      // grow the run in both directions from x
+      unsigned int left = x;
+      while (left > 0 && !visited.Get(left - 1, span.y) && inTolerance(left - 1, span.y, config, mask)) {
+        left--;
+      }
+      unsigned int right = x;
+      while (right + 1 < config.img.width() && !visited.Get(right + 1, span.y) && inTolerance(right + 1, span.y, config, mask)) {
+        right++;
+      }
+
+      fillRun(left, right, span.y, visited, config, anim, framecount);
+
+      if (span.y > 0) {
+        Span above = { left, right, span.y - 1 };
+        spans.Push(above);
+      }
+      if (span.y + 1 < config.img.height()) {
+        Span below = { left, right, span.y + 1 };
+        spans.Push(below);
+      }
+      x = right + 1;
     }
   }
-  anim.addFrame(config.img);
+  anim.endFrame();
   return anim;
 }
 
-bool filler::isVisited(PixelPoint pixel, vector<vector<PixelPoint>> &visited) {
-  PixelPoint entry = visited[pixel.x][pixel.y];
-  return entry.x == pixel.x && entry.y == pixel.y;
+/*
+*  Returns config.mask if it was built from config.source, the image
+*  config.img was copied from, for this fill's seed colour and tolerance, and
+*  otherwise null. A mask of a different image, even one of the same size,
+*  would give a wrong fill.
+*/
+const ToleranceMask* filler::sharedMask(FillerConfig const& config) {
+  if (config.mask && config.source && config.mask->Source() == config.source &&
+      config.mask->Width() == config.img.width() && config.mask->Height() == config.img.height() &&
+      config.mask->Matches(config.seedpoint.color, config.tolerance)) {
+    return config.mask.get();
+  }
+  return nullptr;
+}
+
+/*
+*  Returns true if the pixel at (x, y) is within tolerance of the seed
+*  colour, looking it up in mask if there is one.
+*  PRE: (x, y) lies within the image and has not been filled yet.
+*/
+bool filler::inTolerance(unsigned int x, unsigned int y, FillerConfig const& config, const ToleranceMask* mask) {
+  if (mask) {
+    return mask->Get(x, y);
+  }
+  return config.img.getPixel(x, y)->dist(config.seedpoint.color) <= config.tolerance;
+}
+
+/*
+*  Fills the pixels [left, right] of row y, marking them visited and adding
+*  a frame to the animation after every frameFreq filled pixels. The run is
+*  painted in as few picker calls as the frame boundaries allow.
+*/
+void filler::fillRun(unsigned int left, unsigned int right, unsigned int y, PixelBitmap& visited,
+                     FillerConfig& config, animation& anim, int& framecount) {
+  unsigned int x = left;
+  while (x <= right) {
+    unsigned int count = min(right - x + 1, pixelsToFrame(framecount, config));
+    for (unsigned int i = 0; i < count; i++) {
+      visited.Set(x + i, y);
+    }
+    paintSpan(x, y, count, config, anim);
+    framecount += count;
+    if (framecount % config.frameFreq == 0) {
+      anim.endFrame();
+    }
+    x += count;
+  }
+}
+
+/*
+*  Fills the regions of several seeds at once.
+*
+*  Ownership of each pixel is recorded in owners as (seed index + 1), with 0
+*  meaning unclaimed. Exploring threads only ever lower a pixel's owner, so
+*  once every seed has been explored each claimed pixel holds the lowest
+*  index of the seeds that reached it, whatever order the threads ran in.
+*
+*  PARAM:  config - FillerConfig struct with data for flood fill of image
+*  PARAM:  seeds - seed points to fill from
+*  PARAM:  pickers - picker for each seed, or empty to use config.picker
+*  PARAM:  numthreads - number of exploring threads, or 0 for one per hardware thread
+*  RETURN: animation object illustrating progression of flood fill algorithm
+*/
+animation filler::FillSeeds(FillerConfig& config, vector<PixelPoint> const& seeds,
+                            vector<ColorPicker*> const& pickers, unsigned int numthreads) {
+  assert(pickers.empty() || pickers.size() == seeds.size());
+  assert((uint64_t) config.img.width() * config.img.height() <= UINT32_MAX);
+
+  int framecount = 0;
+  animation anim;
+  startAnimation(config, anim);
+  size_t area = (size_t) config.img.width() * config.img.height();
+  vector<atomic<uint32_t>> owners(area); // value-initialised, so every pixel starts unclaimed
+  atomic<size_t> nextseed(0);
+
+  if (numthreads == 0) {
+    numthreads = max(thread::hardware_concurrency(), 1u);
+  }
+  numthreads = (unsigned int) min((size_t) numthreads, max(seeds.size(), (size_t) 1));
+
+  // the calling thread explores alongside the workers
+  vector<thread> workers;
+  for (unsigned int i = 1; i < numthreads; i++) {
+    workers.push_back(thread(exploreSeeds, cref(config), cref(seeds), ref(nextseed), ref(owners)));
+  }
+  exploreSeeds(config, seeds, nextseed, owners);
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+
+  // paint row by row, one picker call per run of pixels with the same owner
+  ColorPicker* defaultpicker = config.picker;
+  for (unsigned int y = 0; y < config.img.height(); y++) {
+    atomic<uint32_t>* row = &owners[(size_t) y * config.img.width()];
+    unsigned int x = 0;
+    while (x < config.img.width()) {
+      uint32_t owner = row[x].load(memory_order_relaxed);
+      if (owner == 0) {
+        x++;
+        continue;
+      }
+      unsigned int count = 1;
+      unsigned int limit = min(config.img.width() - x, pixelsToFrame(framecount, config));
+      while (count < limit && row[x + count].load(memory_order_relaxed) == owner) {
+        count++;
+      }
+      config.picker = pickers.empty() ? defaultpicker : pickers[owner - 1];
+      paintSpan(x, y, count, config, anim);
+      framecount += count;
+      if (framecount % config.frameFreq == 0) {
+        anim.endFrame();
+      }
+      x += count;
+    }
+  }
+  config.picker = defaultpicker;
+  anim.endFrame();
+  return anim;
 }
 
-void filler::visit(unsigned int x, unsigned int y, vector<vector<PixelPoint>> &visited, FillerConfig& config) {
-  bool offImage = x >= config.img.width() ||
-    y >= config.img.height() ||
-    x < 0 || y < 0;
-  if (offImage) {
-    return;
+/*
+*  Body of each exploring thread: takes the next unexplored seed until none
+*  are left. The visited bitmap and span stack are kept between seeds, and
+*  only the runs a seed filled are cleared afterwards, so the cost of each
+*  seed is proportional to its region rather than to the image.
+*/
+void filler::exploreSeeds(FillerConfig const& config, vector<PixelPoint> const& seeds,
+                          atomic<size_t>& nextseed, vector<atomic<uint32_t>>& owners) {
+  PixelBitmap visited(config.img.width(), config.img.height());
+  Stack<Span> spans;
+  vector<Span> runs;
+
+  for (size_t i = nextseed++; i < seeds.size(); i = nextseed++) {
+    PixelPoint const& seed = seeds[i];
+    // A seed inside the region of a lower-indexed seed of the same colour has
+    // exactly that region, all of which it would lose, so it can be skipped.
+    uint32_t seedowner = owners[(size_t) seed.y * config.img.width() + seed.x].load();
+    if (seedowner != 0 && seedowner <= i && seeds[seedowner - 1].color == seed.color) {
+      continue;
+    }
+
+    exploreSeed(config, seed, i + 1, visited, spans, runs, owners);
+    for (size_t r = 0; r < runs.size(); r++) {
+      for (unsigned int x = runs[r].left; x <= runs[r].right; x++) {
+        visited.Reset(x, runs[r].y);
+      }
+    }
+    runs.clear();
   }
-  PixelPoint pixel = PixelPoint(x, y, *config.img.getPixel(x, y));
-  if (!isVisited(pixel, visited) && pixel.color.dist(config.seedpoint.color) <= config.tolerance) {
-    config.neighbourorder.Insert(pixel);
+}
+
+/*
+*  Finds the region of one seed with the same span search as FillScanline,
+*  without modifying the image, and claims each of its pixels for owner.
+*  The runs found are appended to runs.
+*/
+void filler::exploreSeed(FillerConfig const& config, PixelPoint const& seed, uint32_t owner,
+                         PixelBitmap& visited, Stack<Span>& spans, vector<Span>& runs,
+                         vector<atomic<uint32_t>>& owners) {
+  unsigned int width = config.img.width();
+  unsigned int height = config.img.height();
+  auto matches = [&](unsigned int x, unsigned int y) {
+    return !visited.Get(x, y) && config.img.getPixel(x, y)->dist(seed.color) <= config.tolerance;
+  };
+
+  Span start = { seed.x, seed.x, seed.y };
+  spans.Push(start);
+
+  while (!spans.IsEmpty()) {
+    Span span = spans.Pop();
+    unsigned int x = span.left;
+    while (x <= span.right) {
+      if (!matches(x, span.y)) {
+        x++;
+        continue;
+      }
+
+      unsigned int left = x;
+      while (left > 0 && matches(left - 1, span.y)) {
+        left--;
+      }
+      unsigned int right = x;
+      while (right + 1 < width && matches(right + 1, span.y)) {
+        right++;
+      }
+
+      for (unsigned int i = left; i <= right; i++) {
+        visited.Set(i, span.y);
+        claimPixel(owners[(size_t) span.y * width + i], owner);
+      }
+      Span run = { left, right, span.y };
+      runs.push_back(run);
+
+      if (span.y > 0) {
+        Span above = { left, right, span.y - 1 };
+        spans.Push(above);
+      }
+      if (span.y + 1 < height) {
+        Span below = { left, right, span.y + 1 };
+        spans.Push(below);
+      }
+      x = right + 1;
+    }
   }
-  visited[pixel.x][pixel.y] = pixel;
 }
 
-void filler::applyPicker(PixelPoint const pixel, FillerConfig& config) {
-  *config.img.getPixel(pixel.x, pixel.y) = (*config.picker)(pixel);
-}
\ No newline at end of file
+/*
+*  Lowers pixelowner to owner if it is unclaimed or held by a higher-indexed seed.
+*/
+void filler::claimPixel(atomic<uint32_t>& pixelowner, uint32_t owner) {
+  uint32_t current = pixelowner.load(memory_order_relaxed);
+  while ((current == 0 || owner < current) &&
+         !pixelowner.compare_exchange_weak(current, owner, memory_order_relaxed)) {
+  }
+}
@@ -6,16 +6,25 @@
 #ifndef _FILLER_H_
 #define _FILLER_H_
 
+#include <assert.h>
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <stdint.h>
+#include <thread>
+#include <vector>
 
 #include "cs221util/PNG.h"
 
 #include "animation.h"
+#include "imagehandle.h"
+#include "pixelbitmap.h"
 #include "pixelpoint.h"
 #include "priority.h"
 #include "colorPicker.h"
 #include "queue.h"
 #include "stack.h"
+#include "tolerancemask.h"
 
 using namespace std;
 using namespace cs221util;
@@ -39,6 +48,12 @@ namespace filler
     PixelPoint seedpoint;               // Seed location where the fill will begin.
     PriorityNeighbours neighbourorder;  // Structure for determining order of neighbours to explore (to add to the ordering structure)
     ColorPicker* picker;                // colorPicker used to fill the region.
+    string streamFile;                  // If not empty, GIF file to encode frames to as the fill runs, instead of keeping them.
+    ImageHandle source;                 // If set, the image img is an unchanged copy of.
+    shared_ptr<const ToleranceMask> mask; // If built from source, seedpoint.color and tolerance, used by FillBFS, FillDFS
+                                          // and FillScanline to test pixels, so one mask serves many fills. Without
+                                          // it, fills test each pixel's colour as they reach it, so a fill only costs
+                                          // time in proportion to its region; building a mask costs O(W x H).
   };
 
   /*
@@ -65,10 +80,111 @@ namespace filler
   */
   template <template <class T> class OrderingStructure> animation Fill(FillerConfig& config);
 
+  /*
+  *  Run a flood fill on an image starting at the seed point, colouring it
+  *  with picker instead of config.picker. The picker's type is a template
+  *  parameter, so each pixel is coloured by calling Picker::operator()
+  *  directly (see PickColor) rather than through a virtual call, which lets
+  *  the compiler inline it where its definition is visible. With Picker =
+  *  ColorPicker this is the same as Fill(config) with config.picker.
+  *
+  *  PARAM: config - FillerConfig struct with data for flood fill of image;
+  *                  config.picker is not used.
+  *  PARAM: picker - picker used to fill the region.
+  *  RETURN: animation object illustrating progression of flood fill algorithm.
+  */
+  template <template <class T> class OrderingStructure, class Picker>
+  animation Fill(FillerConfig& config, Picker& picker);
+
+  /*
+  *  Breadth and depth first search fills with a picker of known type.
+  *  See Fill(config, picker).
+  */
+  template <class Picker> animation FillBFS(FillerConfig& config, Picker& picker);
+  template <class Picker> animation FillDFS(FillerConfig& config, Picker& picker);
+
+  /*
+  *  Performs a flood fill by growing horizontal runs of pixels and pushing
+  *  the spans above and below each run, tracking visited pixels in a
+  *  1-bit-per-pixel bitmap. Fills the same region as FillBFS and FillDFS,
+  *  but pixels are filled in scanline order rather than in neighbour priority
+  *  order, so it is only suitable when the animation ordering does not matter
+  *  (e.g. not with RainbowColorPicker, whose colours depend on fill order).
+  *
+  *  PARAM:  config - FillerConfig struct to setup the fill. neighbourorder is not used.
+  *  RETURN: animation object illustrating progression of flood fill algorithm.
+  */
+  animation FillScanline(FillerConfig& config);
+
+  /*
+  *  Fills the regions of several seeds at once. Each seed's region is the
+  *  set of pixels connected to it that are within config.tolerance of that
+  *  seed's colour, found on the image as it was before any filling, so the
+  *  regions do not depend on one another and are explored concurrently on
+  *  up to numthreads threads. A pixel in more than one region belongs to the
+  *  lowest-indexed seed whose region contains it, regardless of which thread
+  *  reaches it first. Regions are then painted on the calling thread in
+  *  row-major order, so as with FillScanline the animation ordering differs
+  *  from FillBFS and FillDFS.
+  *
+  *  Only exploration scales with numthreads. Painting, and every picker
+  *  call, stays on the calling thread: frames are cut after every
+  *  config.frameFreq painted pixels in row-major order, and pickers such as
+  *  RainbowColorPicker are not thread-safe. The serial paint bounds the
+  *  speedup (see benchFills). Each exploring thread also holds a visited
+  *  bitmap of one bit per image pixel.
+  *
+  *  PARAM:  config - FillerConfig struct with the image, tolerance, frame
+  *                   frequency and default picker. seedpoint and
+  *                   neighbourorder are not used.
+  *  PARAM:  seeds - seed points, each holding its pixel's colour.
+  *  PARAM:  pickers - picker for each seed, or empty to use config.picker
+  *                    for every seed.
+  *  PARAM:  numthreads - number of threads to explore with, or 0 to use one
+  *                       per hardware thread.
+  *  PRE:    every seed lies within the image, config.img has fewer than
+  *          2^32 pixels, and pickers is empty or the same size as seeds.
+  *  RETURN: animation object illustrating progression of flood fill algorithm.
+  */
+  animation FillSeeds(FillerConfig& config, vector<PixelPoint> const& seeds,
+                      vector<ColorPicker*> const& pickers = vector<ColorPicker*>(),
+                      unsigned int numthreads = 0);
+
+  /*
+  *  A candidate interval of a row, bordering a run that has just been filled.
+  */
+  struct Span {
+    unsigned int left;  // first x-coordinate of the interval
+    unsigned int right; // last x-coordinate of the interval
+    unsigned int y;     // row of the interval
+  };
+
   // Add any helper functions here
-  bool isVisited(PixelPoint pixel, vector<vector<PixelPoint>> &visited);
-  void visit(unsigned int x, unsigned int y, vector<vector<PixelPoint>> &visited, FillerConfig& config);
-  void applyPicker(PixelPoint const pixel, FillerConfig& config);
+  const unsigned int ORDERBITS = 5;                         // bits of a work item holding its neighbour order
+  const uint64_t MAXITEMINDEX = (uint64_t) 1 << (32 - ORDERBITS); // limit on image pixels for packed work items
+  const int NEIGHBOURDX[4] = { 0, 0, -1, 1 };               // x offsets of the up, down, left and right neighbours
+  const int NEIGHBOURDY[4] = { -1, 1, 0, 0 };               // y offsets of the up, down, left and right neighbours
+
+  unsigned int neighbourOrder(unsigned int x, unsigned int y, HSLAPixel color, PixelBitmap& visited, FillerConfig& config);
+  unsigned int encodeOrder(const unsigned char directions[4]);
+  void decodeOrder(unsigned int code, unsigned char directions[4]);
+  uint32_t packItem(unsigned int x, unsigned int y, unsigned int order, unsigned int width);
+  void unpackItem(uint32_t item, unsigned int width, unsigned int& x, unsigned int& y, unsigned int& order);
+  void startAnimation(FillerConfig& config, animation& anim);
+  template <class Picker>
+  void applyPicker(PixelPoint const pixel, Picker& picker, FillerConfig& config, animation& anim);
+  void paintSpan(unsigned int x, unsigned int y, unsigned int count, FillerConfig& config, animation& anim);
+  unsigned int pixelsToFrame(int framecount, FillerConfig const& config);
+  const ToleranceMask* sharedMask(FillerConfig const& config);
+  bool inTolerance(unsigned int x, unsigned int y, FillerConfig const& config, const ToleranceMask* mask);
+  void fillRun(unsigned int left, unsigned int right, unsigned int y, PixelBitmap& visited,
+               FillerConfig& config, animation& anim, int& framecount);
+  void exploreSeeds(FillerConfig const& config, vector<PixelPoint> const& seeds,
+                    atomic<size_t>& nextseed, vector<atomic<uint32_t>>& owners);
+  void exploreSeed(FillerConfig const& config, PixelPoint const& seed, uint32_t owner,
+                   PixelBitmap& visited, Stack<Span>& spans, vector<Span>& runs,
+                   vector<atomic<uint32_t>>& owners);
+  void claimPixel(atomic<uint32_t>& pixelowner, uint32_t owner);
 } // namespace filler
 
 #include "filler.cpp"
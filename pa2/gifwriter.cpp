@@ -0,0 +1,275 @@
+/*
+*  File:        gifwriter.cpp
+*  Description: Implementation of the GifWriter class.
+*
+*/
+
+#include "gifwriter.h"
+
+// RGB_HSL.h defines its conversions as static functions; only hsl2rgb is used here
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "cs221util/RGB_HSL.h"
+#pragma GCC diagnostic pop
+
+#define PALETTEREDS 6
+#define PALETTEGREENS 7
+#define PALETTEBLUES 6
+#define MINCODESIZE 8
+#define CLEARCODE 256
+#define ENDCODE 257
+#define MAXCODE 4095
+#define DICTIONARYSIZE 8192
+
+GifWriter::GifWriter() {
+  width = 0;
+  height = 0;
+  delay = 0;
+  firstframe = true;
+  bitbuffer = 0;
+  bitcount = 0;
+  clearDirty();
+}
+
+GifWriter::~GifWriter() {
+  if (out.is_open()) {
+    Close();
+  }
+}
+
+bool GifWriter::Open(string const& filename, unsigned int w, unsigned int h, unsigned int d) {
+  out.open(filename.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!out.is_open()) {
+    return false;
+  }
+  width = w;
+  height = h;
+  delay = d;
+  firstframe = true;
+  canvas.assign((size_t) w * h, 0);
+  clearDirty();
+
+  // header and logical screen descriptor, with a 256-entry global palette
+  out.write("GIF89a", 6);
+  writeWord(w);
+  writeWord(h);
+  out.put((char) 0xF7);
+  out.put(0);
+  out.put(0);
+
+  for (int i = 0; i < 256; i++) {
+    int r = 0, g = 0, b = 0;
+    if (i < PALETTEREDS * PALETTEGREENS * PALETTEBLUES) {
+      r = (i / (PALETTEGREENS * PALETTEBLUES)) * 255 / (PALETTEREDS - 1);
+      g = (i / PALETTEBLUES % PALETTEGREENS) * 255 / (PALETTEGREENS - 1);
+      b = (i % PALETTEBLUES) * 255 / (PALETTEBLUES - 1);
+    }
+    out.put((char) r);
+    out.put((char) g);
+    out.put((char) b);
+  }
+
+  // loop forever
+  out.write("\x21\xFF\x0BNETSCAPE2.0\x03\x01\x00\x00\x00", 19);
+  return out.good();
+}
+
+bool GifWriter::IsOpen() const {
+  return out.is_open();
+}
+
+void GifWriter::SetPixel(unsigned int x, unsigned int y, HSLAPixel const& pixel) {
+  uint8_t index = PaletteIndex(pixel);
+  uint8_t& current = canvas[(size_t) y * width + x];
+  if (current != index) {
+    current = index;
+    markDirty(x, y);
+  }
+}
+
+void GifWriter::SetImage(PNG const& img) {
+  for (unsigned int y = 0; y < height; y++) {
+    for (unsigned int x = 0; x < width; x++) {
+      SetPixel(x, y, *img.getPixel(x, y));
+    }
+  }
+}
+
+void GifWriter::WriteFrame() {
+  if (firstframe) {
+    encodeRect(0, 0, width, height);
+    firstframe = false;
+  } else if (dirtyleft > dirtyright) {
+    encodeRect(0, 0, 1, 1);
+  } else {
+    encodeRect(dirtyleft, dirtytop, dirtyright - dirtyleft + 1, dirtybottom - dirtytop + 1);
+  }
+  clearDirty();
+}
+
+bool GifWriter::Close() {
+  out.put(0x3B);
+  bool ok = out.good();
+  out.close();
+  canvas.clear();
+  return ok;
+}
+
+uint8_t GifWriter::PaletteIndex(HSLAPixel const& pixel) {
+  hslaColor hsl;
+  hsl.h = pixel.h;
+  hsl.s = pixel.s;
+  hsl.l = pixel.l;
+  hsl.a = pixel.a;
+  rgbaColor rgb = hsl2rgb(hsl);
+
+  int r = (rgb.r * (PALETTEREDS - 1) + 127) / 255;
+  int g = (rgb.g * (PALETTEGREENS - 1) + 127) / 255;
+  int b = (rgb.b * (PALETTEBLUES - 1) + 127) / 255;
+  return (uint8_t) ((r * PALETTEGREENS + g) * PALETTEBLUES + b);
+}
+
+void GifWriter::markDirty(unsigned int x, unsigned int y) {
+  if (dirtyleft > dirtyright) {
+    dirtyleft = dirtyright = x;
+    dirtytop = dirtybottom = y;
+    return;
+  }
+  dirtyleft = min(dirtyleft, x);
+  dirtyright = max(dirtyright, x);
+  dirtytop = min(dirtytop, y);
+  dirtybottom = max(dirtybottom, y);
+}
+
+void GifWriter::clearDirty() {
+  dirtyleft = 1;
+  dirtyright = 0;
+  dirtytop = 1;
+  dirtybottom = 0;
+}
+
+/*
+*  Writes a 16-bit value, least significant byte first.
+*/
+void GifWriter::writeWord(unsigned int value) {
+  out.put((char) (value & 0xFF));
+  out.put((char) ((value >> 8) & 0xFF));
+}
+
+/*
+*  Writes one frame covering a rectangle of the canvas: a graphic control
+*  extension (frame delay, previous frame left in place underneath), an
+*  image descriptor, and the LZW-compressed palette indices.
+*/
+void GifWriter::encodeRect(unsigned int left, unsigned int top, unsigned int w, unsigned int h) {
+  out.write("\x21\xF9\x04\x04", 4);
+  writeWord(delay);
+  out.put(0);
+  out.put(0);
+
+  out.put(0x2C);
+  writeWord(left);
+  writeWord(top);
+  writeWord(w);
+  writeWord(h);
+  out.put(0);
+
+  out.put(MINCODESIZE);
+  resetDictionary();
+  unsigned int codesize = MINCODESIZE + 1;
+  unsigned int maxcode = ENDCODE;
+  int prefix = -1;
+  writeCode(CLEARCODE, codesize);
+
+  for (unsigned int y = top; y < top + h; y++) {
+    const uint8_t* row = &canvas[(size_t) y * width];
+    for (unsigned int x = left; x < left + w; x++) {
+      uint8_t suffix = row[x];
+      if (prefix < 0) {
+        prefix = suffix;
+        continue;
+      }
+
+      uint32_t key = ((uint32_t) prefix << 8 | suffix) + 1;
+      size_t slot;
+      int code = findCode(key, slot);
+      if (code >= 0) {
+        prefix = code;
+        continue;
+      }
+
+      writeCode(prefix, codesize);
+      maxcode++;
+      dictkeys[slot] = key;
+      dictcodes[slot] = maxcode;
+      if (maxcode >= (1u << codesize)) {
+        codesize++;
+      }
+      if (maxcode == MAXCODE) {
+        writeCode(CLEARCODE, codesize);
+        resetDictionary();
+        codesize = MINCODESIZE + 1;
+        maxcode = ENDCODE;
+      }
+      prefix = suffix;
+    }
+  }
+
+  writeCode(prefix, codesize);
+  writeCode(ENDCODE, codesize);
+  if (bitcount > 0) {
+    block.push_back((uint8_t) bitbuffer);
+    bitbuffer = 0;
+    bitcount = 0;
+  }
+  flushBlock();
+  out.put(0);
+}
+
+void GifWriter::resetDictionary() {
+  dictkeys.assign(DICTIONARYSIZE, 0);
+  dictcodes.resize(DICTIONARYSIZE);
+}
+
+/*
+*  Looks up a (prefix, suffix) key in the dictionary by linear probing.
+*  Returns its code, or -1 if absent, in which case slot is where it belongs.
+*/
+int GifWriter::findCode(uint32_t key, size_t& slot) const {
+  slot = (key * 2654435761u) >> 19 & (DICTIONARYSIZE - 1);
+  while (dictkeys[slot] != 0) {
+    if (dictkeys[slot] == key) {
+      return dictcodes[slot];
+    }
+    slot = (slot + 1) & (DICTIONARYSIZE - 1);
+  }
+  return -1;
+}
+
+/*
+*  Appends a code to the data, least significant bit first.
+*/
+void GifWriter::writeCode(unsigned int code, unsigned int size) {
+  bitbuffer |= code << bitcount;
+  bitcount += size;
+  while (bitcount >= 8) {
+    block.push_back((uint8_t) bitbuffer);
+    bitbuffer >>= 8;
+    bitcount -= 8;
+    if (block.size() == 255) {
+      flushBlock();
+    }
+  }
+}
+
+/*
+*  Writes the pending bytes as one data sub-block.
+*/
+void GifWriter::flushBlock() {
+  if (block.empty()) {
+    return;
+  }
+  out.put((char) block.size());
+  out.write((const char*) &block[0], block.size());
+  block.clear();
+}
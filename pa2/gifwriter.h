@@ -0,0 +1,120 @@
+/*
+*  File:        gifwriter.h
+*  Description: Definition of a GifWriter class, which encodes an animated GIF
+*               one frame at a time, so that frames never need to be kept.
+*
+*/
+
+#ifndef _GIFWRITER_H_
+#define _GIFWRITER_H_
+
+#include <fstream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "cs221util/HSLAPixel.h"
+#include "cs221util/PNG.h"
+
+using namespace std;
+using namespace cs221util;
+
+/*
+*  GifWriter keeps a canvas of palette indices the size of the animation.
+*  Pixels are changed on the canvas, and each call to WriteFrame encodes only
+*  the bounding rectangle of the pixels changed since the previous frame.
+*  Memory use is one byte per pixel plus a fixed-size LZW dictionary.
+*
+*  All frames share one fixed palette: a 6 x 7 x 6 grid of red, green and
+*  blue levels. Pixels are quantized to the nearest grid colour.
+*/
+class GifWriter {
+  public:
+    /*
+    *  Constructs a writer with no file open.
+    */
+    GifWriter();
+
+    /*
+    *  Closes the file if it is still open.
+    */
+    ~GifWriter();
+
+    /*
+    *  Creates the file and writes the GIF header and palette. The canvas
+    *  starts out black.
+    *  PARAM:  filename - name of the file to write
+    *  PARAM:  w - width of the animation, in pixels
+    *  PARAM:  h - height of the animation, in pixels
+    *  PARAM:  delay - time to show each frame, in hundredths of a second
+    *  RETURN: true if the file was created.
+    */
+    bool Open(string const& filename, unsigned int w, unsigned int h, unsigned int delay = 2);
+
+    /*
+    *  Returns true if a file is open.
+    */
+    bool IsOpen() const;
+
+    /*
+    *  Changes one pixel of the canvas.
+    *  PRE: (x, y) lies within the canvas.
+    */
+    void SetPixel(unsigned int x, unsigned int y, HSLAPixel const& pixel);
+
+    /*
+    *  Changes the canvas to match an image.
+    *  PRE: img has the dimensions given to Open.
+    */
+    void SetImage(PNG const& img);
+
+    /*
+    *  Encodes the canvas as the next frame. The first frame is encoded in
+    *  full; later frames only cover the pixels changed since the one before.
+    *  If nothing has changed, a 1 x 1 frame is written so the frame still
+    *  takes its share of the animation time.
+    *  PRE: IsOpen().
+    */
+    void WriteFrame();
+
+    /*
+    *  Writes the GIF trailer and closes the file.
+    *  RETURN: true if every write succeeded.
+    */
+    bool Close();
+
+    /*
+    *  Returns the palette index nearest to a pixel's colour.
+    */
+    static uint8_t PaletteIndex(HSLAPixel const& pixel);
+
+  private:
+    ofstream out;             // file being written
+    unsigned int width;       // width of the canvas, in pixels
+    unsigned int height;      // height of the canvas, in pixels
+    unsigned int delay;       // frame delay, in hundredths of a second
+    bool firstframe;          // whether no frame has been written yet
+    vector<uint8_t> canvas;   // palette index of every pixel, row-major
+
+    // bounding rectangle of the pixels changed since the last frame;
+    // empty when dirtyleft > dirtyright
+    unsigned int dirtyleft, dirtyright, dirtytop, dirtybottom;
+
+    // LZW encoder state
+    vector<uint32_t> dictkeys;   // (prefix << 8 | suffix) + 1 for each slot, 0 if empty
+    vector<uint16_t> dictcodes;  // code of each slot
+    vector<uint8_t> block;       // data sub-block being filled
+    uint32_t bitbuffer;          // bits not yet written to block
+    unsigned int bitcount;       // number of bits in bitbuffer
+
+    void markDirty(unsigned int x, unsigned int y);
+    void clearDirty();
+    void writeWord(unsigned int value);
+    void encodeRect(unsigned int left, unsigned int top, unsigned int w, unsigned int h);
+    void resetDictionary();
+    int findCode(uint32_t key, size_t& slot) const;
+    void writeCode(unsigned int code, unsigned int size);
+    void flushBlock();
+};
+
+#endif
@@ -7,9 +7,9 @@
 #include "imageTileColorPicker.h"
 
 ImageTileColorPicker::ImageTileColorPicker(PNG& otherimage) {
-  img_other = otherimage;
+  img_other = ShareImage(otherimage);
 }
 
-HSLAPixel ImageTileColorPicker::operator()(PixelPoint p) {
-  return *img_other.getPixel(p.x % img_other.width(), p.y % img_other.height());
-}
\ No newline at end of file
+ImageTileColorPicker::ImageTileColorPicker(ImageHandle otherimage) {
+  img_other = otherimage;
+}
@@ -6,14 +6,20 @@
 #ifndef _IMAGETILECOLORPICKER_H_
 #define _IMAGETILECOLORPICKER_H_
 
+#include <algorithm>
+
 #include "colorPicker.h"
+#include "imagehandle.h"
+#include "pixelspan.h"
 
 /*
 *  imageTileColorPicker: a functor that determines the color that should be used
 *  given a point using color values from a different image.
 *
+*  Its picking functions are defined here, and the class is final, so that a
+*  fill templated on ImageTileColorPicker can inline them.
 */
-class ImageTileColorPicker : public ColorPicker
+class ImageTileColorPicker final : public ColorPicker
 {
   public:
     /*
@@ -24,6 +30,14 @@ class ImageTileColorPicker : public ColorPicker
     */
     ImageTileColorPicker(PNG& otherimage);
 
+    /*
+    *  Constructs a new ImageTileColorPicker that shares otherimage instead
+    *  of copying it.
+    *
+    *  PRE:   otherimage has dimensions at least 1x1
+    */
+    ImageTileColorPicker(ImageHandle otherimage);
+
     /*
     *  Picks the color for pixel (x, y).
     *  img_other is tiled across the dimensions of img_main, starting at (0,0).
@@ -36,10 +50,29 @@ class ImageTileColorPicker : public ColorPicker
     *  PARAM:  p - The point for which you're picking a color
     *  RETURN: The color chosen for (p).
     */
-    virtual HSLAPixel operator()(PixelPoint p);
+    virtual HSLAPixel operator()(PixelPoint p) {
+      return *img_other->getPixel(p.x % img_other->width(), p.y % img_other->height());
+    }
+
+    /*
+    *  Copies a run of the tiled image, in as few pieces as the tiling allows.
+    */
+    virtual void PickSpan(unsigned int x, unsigned int y, unsigned int count,
+                          const HSLAPixel* /* originals */, HSLAPixel* out) {
+      unsigned int tilex = x % img_other->width();
+      const HSLAPixel* row = img_other->getPixel(0, y % img_other->height());
+      while (count > 0) {
+        // copy up to the right edge of the tile, then wrap around to its left edge
+        unsigned int n = std::min(count, img_other->width() - tilex);
+        CopySpan(out, row + tilex, n);
+        out += n;
+        count -= n;
+        tilex = 0;
+      }
+    }
 
   private:
-    PNG img_other;   // image from which colors will be taken
+    ImageHandle img_other;   // image from which colors will be taken
 };
 
 #endif
@@ -0,0 +1,48 @@
+/*
+*  File:        imagehandle.h
+*  Description: Shared, read-only handles to images, so that several color
+*               pickers can read the same source pixels without each keeping
+*               its own copy.
+*
+*/
+
+#ifndef _IMAGEHANDLE_H_
+#define _IMAGEHANDLE_H_
+
+#include <memory>
+
+#include "cs221util/PNG.h"
+
+using namespace std;
+using namespace cs221util;
+
+/*
+*  A reference-counted handle to an image that its holders only read.
+*  Copying a handle shares the image; the image is freed with its last
+*  owning handle.
+*/
+typedef shared_ptr<const PNG> ImageHandle;
+
+/*
+*  Returns a handle owning a copy of img. This is the one copy made; every
+*  picker given the handle (or a copy of it) shares it.
+*/
+inline ImageHandle ShareImage(const PNG& img) {
+  return make_shared<const PNG>(img);
+}
+
+/*
+*  Returns a handle that refers to img without owning or copying it.
+*
+*  PRE: img outlives every copy of the handle. If img changes, holders see
+*       the changes, so a view of the image being filled (FillerConfig::img)
+*       only suits pickers that read the original colour of the pixel being
+*       picked and nothing else, such as NegativeColorPicker and
+*       CensorColorPicker (whose block averages are computed from the image
+*       before the fill starts).
+*/
+inline ImageHandle ViewImage(const PNG& img) {
+  return ImageHandle(&img, [](const PNG*) {});
+}
+
+#endif
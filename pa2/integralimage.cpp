@@ -0,0 +1,67 @@
+/*
+*  File:        integralimage.cpp
+*  Description: Implementation of the IntegralImage class.
+*
+*/
+
+#include "integralimage.h"
+
+#include <algorithm>
+#include <assert.h>
+
+IntegralImage::IntegralImage(const PNG& img) {
+  width = img.width();
+  height = img.height();
+  sums.resize((size_t) (width + 1) * (height + 1));
+
+  ChannelSums zero = { 0, 0, 0, 0 };
+  for (unsigned int x = 0; x <= width; x++) {
+    sums[x] = zero;
+  }
+  for (unsigned int y = 1; y <= height; y++) {
+    // running sums along the row, added to the row above
+    ChannelSums row = zero;
+    sums[(size_t) y * (width + 1)] = zero;
+    for (unsigned int x = 1; x <= width; x++) {
+      const HSLAPixel* pixel = img.getPixel(x - 1, y - 1);
+      row.h += pixel->h;
+      row.s += pixel->s;
+      row.l += pixel->l;
+      row.a += pixel->a;
+      const ChannelSums& above = At(x, y - 1);
+      ChannelSums& entry = sums[(size_t) y * (width + 1) + x];
+      entry.h = above.h + row.h;
+      entry.s = above.s + row.s;
+      entry.l = above.l + row.l;
+      entry.a = above.a + row.a;
+    }
+  }
+}
+
+HSLAPixel IntegralImage::Average(unsigned int left, unsigned int top, unsigned int right, unsigned int bottom) const {
+  right = min(right, width);
+  bottom = min(bottom, height);
+  assert(left < right && top < bottom);
+
+  const ChannelSums& br = At(right, bottom);
+  const ChannelSums& bl = At(left, bottom);
+  const ChannelSums& tr = At(right, top);
+  const ChannelSums& tl = At(left, top);
+  double count = (double) (right - left) * (bottom - top);
+  return HSLAPixel((br.h - bl.h - tr.h + tl.h) / count,
+                   (br.s - bl.s - tr.s + tl.s) / count,
+                   (br.l - bl.l - tr.l + tl.l) / count,
+                   (br.a - bl.a - tr.a + tl.a) / count);
+}
+
+unsigned int IntegralImage::Width() const {
+  return width;
+}
+
+unsigned int IntegralImage::Height() const {
+  return height;
+}
+
+const IntegralImage::ChannelSums& IntegralImage::At(unsigned int x, unsigned int y) const {
+  return sums[(size_t) y * (width + 1) + x];
+}
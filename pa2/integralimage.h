@@ -0,0 +1,57 @@
+/*
+*  File:        integralimage.h
+*  Description: Definition of an IntegralImage class, a summed-area table of
+*               the H/S/L/A channels of an image. Any rectangle's channel
+*               sums, and so its average colour, take O(1) to look up.
+*
+*/
+
+#ifndef _INTEGRALIMAGE_H_
+#define _INTEGRALIMAGE_H_
+
+#include <vector>
+
+#include "cs221util/HSLAPixel.h"
+#include "cs221util/PNG.h"
+
+using namespace std;
+using namespace cs221util;
+
+class IntegralImage {
+  public:
+    /*
+    *  Builds the table for an image, in O(W x H).
+    *  PARAM: img - image to sum
+    */
+    IntegralImage(const PNG& img);
+
+    /*
+    *  Returns the arithmetic mean of each of the H/S/L/A channels over the
+    *  rectangle [left, right) x [top, bottom), clipped to the image.
+    *  PRE: the clipped rectangle is not empty.
+    */
+    HSLAPixel Average(unsigned int left, unsigned int top, unsigned int right, unsigned int bottom) const;
+
+    /*
+    *  Returns the dimensions of the summed image.
+    */
+    unsigned int Width() const;
+    unsigned int Height() const;
+
+  private:
+    /*
+    *  Channel sums over the rectangle from the image origin to a corner.
+    */
+    struct ChannelSums {
+      double h, s, l, a;
+    };
+
+    unsigned int width;        // width of the summed image
+    unsigned int height;       // height of the summed image
+    vector<ChannelSums> sums;  // (width + 1) x (height + 1) table, row-major;
+                               // entry (x, y) sums the pixels [0, x) x [0, y)
+
+    const ChannelSums& At(unsigned int x, unsigned int y) const;
+};
+
+#endif
@@ -0,0 +1,47 @@
+/*
+*  File:        layeredColorPicker.h
+*  Description: Definition of a color picker that composes two other
+*               pickers at compile time.
+*
+*/
+#ifndef _LAYEREDCOLORPICKER_H_
+#define _LAYEREDCOLORPICKER_H_
+
+#include "colorPicker.h"
+
+/*
+*  LayeredColorPicker: a functor that lays one picker over another. Where
+*  the top picker covers a point, its color is used; everywhere else the
+*  bottom picker's color shows through. For example, a
+*  LayeredColorPicker<CensorColorPicker, ImageTileColorPicker> mosaics the
+*  censor's circle and tiles the rest of the region.
+*
+*  Both pickers are held by reference and called through PickColor, so the
+*  layered picker makes no virtual calls of its own. Layers stack by using
+*  a LayeredColorPicker as the bottom of another.
+*
+*  Top must provide bool Covers(PixelPoint) (see CensorColorPicker::Covers).
+*/
+template <class Top, class Bottom>
+class LayeredColorPicker final : public ColorPicker
+{
+  public:
+    /*
+    *  Constructs a picker layering top over bottom. Both must outlive it.
+    */
+    LayeredColorPicker(Top& topPicker, Bottom& bottomPicker) : top(topPicker), bottom(bottomPicker) {}
+
+    /*
+    *  Picks the top picker's color for p if it covers p, and the bottom
+    *  picker's color otherwise.
+    */
+    virtual HSLAPixel operator()(PixelPoint p) {
+      return top.Covers(p) ? PickColor(top, p) : PickColor(bottom, p);
+    }
+
+  private:
+    Top& top;       // picker used where it covers a point
+    Bottom& bottom; // picker used everywhere else
+};
+
+#endif
@@ -8,13 +8,10 @@
 
 NegativeColorPicker::NegativeColorPicker(PNG& inputimg)
 {
-  img = inputimg;
+  img = ShareImage(inputimg);
 }
 
-HSLAPixel NegativeColorPicker::operator()(PixelPoint p)
+NegativeColorPicker::NegativeColorPicker(ImageHandle inputimg)
 {
-  HSLAPixel* pixel = img.getPixel(p.x, p.y);
-  pixel->h = fmod((pixel->h + 180), 360);
-  pixel->l = 1 - pixel->l;
-  return *pixel;
+  img = inputimg;
 }
@@ -11,7 +11,9 @@
 #include "cs221util/HSLAPixel.h"
 
 #include "colorPicker.h"
+#include "imagehandle.h"
 #include "pixelpoint.h"
+#include "pixelspan.h"
 
 using namespace std;
 
@@ -21,8 +23,11 @@ using namespace std;
 *  The final hue and luminance of the (x, y) point has inverted hue and luminance
 *  values of the (x, y) point of the original image.
 *  Saturation and alpha will not be changed.
+*
+*  Its picking functions are defined here, and the class is final, so that a
+*  fill templated on NegativeColorPicker can inline them.
 */
-class NegativeColorPicker : public ColorPicker
+class NegativeColorPicker final : public ColorPicker
 {
   public:
     /*
@@ -30,6 +35,12 @@ class NegativeColorPicker : public ColorPicker
     */
     NegativeColorPicker(PNG& inputimg);
 
+    /*
+    *  Constructs a new NegativeColorPicker that shares inputimg instead of
+    *  copying it.
+    */
+    NegativeColorPicker(ImageHandle inputimg);
+
     /*
     *  Picks the color for pixel (x, y), which is a member of point p.
     *  The new color consists of components h, s, and l.
@@ -41,10 +52,23 @@ class NegativeColorPicker : public ColorPicker
     * 
     *  RETURN: The color chosen for (p).
     */
-    virtual HSLAPixel operator()(PixelPoint p);
+    virtual HSLAPixel operator()(PixelPoint p) {
+      HSLAPixel pixel = *img->getPixel(p.x, p.y);
+      pixel.h = fmod((pixel.h + 180), 360);
+      pixel.l = 1 - pixel.l;
+      return pixel;
+    }
+
+    /*
+    *  Picks the negative colors of a run of the original image at once.
+    */
+    virtual void PickSpan(unsigned int x, unsigned int y, unsigned int count,
+                          const HSLAPixel* /* originals */, HSLAPixel* out) {
+      NegateSpan(out, img->getPixel(x, y), count);
+    }
 
   private:
-    PNG img;                  // Original image used in flood fill algorithm
+    ImageHandle img;          // Original image used in flood fill algorithm
 };
 
 #endif
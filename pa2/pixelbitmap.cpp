@@ -0,0 +1,33 @@
+/*
+*  File:        pixelbitmap.cpp
+*  Description: Implementation of the PixelBitmap class.
+*
+*/
+
+#include "pixelbitmap.h"
+
+PixelBitmap::PixelBitmap(unsigned int w, unsigned int h) {
+  Resize(w, h);
+}
+
+void PixelBitmap::Resize(unsigned int w, unsigned int h) {
+  width = w;
+  height = h;
+  bits.assign(((size_t) w * h + 63) / 64, 0);
+}
+
+void PixelBitmap::Clear() {
+  bits.assign(bits.size(), 0);
+}
+
+unsigned int PixelBitmap::Width() const {
+  return width;
+}
+
+unsigned int PixelBitmap::Height() const {
+  return height;
+}
+
+size_t PixelBitmap::Bytes() const {
+  return bits.size() * sizeof(uint64_t);
+}
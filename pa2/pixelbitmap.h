@@ -0,0 +1,97 @@
+/*
+*  File:        pixelbitmap.h
+*  Description: Definition of a PixelBitmap class, a packed grid of one bit per
+*               image pixel. Used by the filler to track visited pixels.
+*
+*/
+
+#ifndef _PIXELBITMAP_H_
+#define _PIXELBITMAP_H_
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+class PixelBitmap {
+  public:
+    /*
+    *  Constructs a bitmap of the given dimensions with every bit cleared.
+    *  PARAM: w - width of the bitmap, in pixels
+    *  PARAM: h - height of the bitmap, in pixels
+    */
+    PixelBitmap(unsigned int w = 0, unsigned int h = 0);
+
+    /*
+    *  Resizes the bitmap to the given dimensions.
+    *  POST: every bit is cleared.
+    */
+    void Resize(unsigned int w, unsigned int h);
+
+    /*
+    *  Clears every bit in the bitmap, keeping its dimensions.
+    */
+    void Clear();
+
+    /*
+    *  Returns the bit for pixel (x, y).
+    *  PRE: (x, y) lies within the bitmap.
+    */
+    bool Get(unsigned int x, unsigned int y) const {
+      size_t i = (size_t) y * width + x;
+      return (bits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    /*
+    *  Sets the bit for pixel (x, y).
+    *  PRE: (x, y) lies within the bitmap.
+    */
+    void Set(unsigned int x, unsigned int y) {
+      size_t i = (size_t) y * width + x;
+      bits[i >> 6] |= (uint64_t) 1 << (i & 63);
+    }
+
+    /*
+    *  Clears the bit for pixel (x, y).
+    *  PRE: (x, y) lies within the bitmap.
+    */
+    void Reset(unsigned int x, unsigned int y) {
+      size_t i = (size_t) y * width + x;
+      bits[i >> 6] &= ~((uint64_t) 1 << (i & 63));
+    }
+
+    /*
+    *  Sets the 64 bits for the pixels with row-major indices 64 * i to
+    *  64 * i + 63 at once, the lowest bit being pixel 64 * i. Bits past the
+    *  last pixel must be 0. Different words may be set from different threads.
+    *  PRE: i < WordCount().
+    */
+    void SetWord(size_t i, uint64_t word) {
+      bits[i] = word;
+    }
+
+    /*
+    *  Returns the number of 64-bit words holding the bits.
+    */
+    size_t WordCount() const {
+      return bits.size();
+    }
+
+    /*
+    *  Returns the dimensions of the bitmap.
+    */
+    unsigned int Width() const;
+    unsigned int Height() const;
+
+    /*
+    *  Returns the number of bytes used to store the bits.
+    */
+    size_t Bytes() const;
+
+  private:
+    unsigned int width;    // width of the bitmap, in pixels
+    unsigned int height;   // height of the bitmap, in pixels
+    vector<uint64_t> bits; // row-major bits, 64 pixels per word
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+*  File:        pixelspan.h
+*  Description: Helpers that write a run of consecutive HSLAPixels at once,
+*               for ColorPicker::PickSpan implementations. An HSLAPixel is
+*               four doubles, so each pixel is moved as two SSE2 registers
+*               where SSE2 is available.
+*
+*/
+
+#ifndef _PIXELSPAN_H_
+#define _PIXELSPAN_H_
+
+#include <math.h>
+#include <string.h>
+
+#include "cs221util/HSLAPixel.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace cs221util;
+
+static_assert(sizeof(HSLAPixel) == 4 * sizeof(double), "HSLAPixel must be exactly its four channels");
+
+/*
+*  Sets out[0..count) to color.
+*/
+inline void FillSpan(HSLAPixel* out, unsigned int count, const HSLAPixel& color) {
+#ifdef __SSE2__
+  __m128d hs = _mm_loadu_pd(&color.h);
+  __m128d la = _mm_loadu_pd(&color.l);
+  for (unsigned int i = 0; i < count; i++) {
+    _mm_storeu_pd(&out[i].h, hs);
+    _mm_storeu_pd(&out[i].l, la);
+  }
+#else
+  for (unsigned int i = 0; i < count; i++) {
+    out[i] = color;
+  }
+#endif
+}
+
+/*
+*  Copies in[0..count) to out[0..count). The ranges may overlap.
+*/
+inline void CopySpan(HSLAPixel* out, const HSLAPixel* in, unsigned int count) {
+  memmove(static_cast<void*>(out), static_cast<const void*>(in), count * sizeof(HSLAPixel));
+}
+
+/*
+*  Sets out[0..count) to the negatives of in[0..count): hue rotated by 180
+*  degrees, luminance inverted, saturation and alpha unchanged.
+*  PRE: every hue is in [0, 360). out and in are the same array, or do not overlap.
+*/
+inline void NegateSpan(HSLAPixel* out, const HSLAPixel* in, unsigned int count) {
+#ifdef __SSE2__
+  // lane 0 holds h (or l), lane 1 holds s (or a)
+  const __m128d halfturn = _mm_set_pd(0.0, 180.0);
+  const __m128d fullturn = _mm_set_pd(0.0, 360.0);
+  const __m128d lumsign = _mm_set_pd(0.0, -0.0);
+  const __m128d one = _mm_set_pd(0.0, 1.0);
+  for (unsigned int i = 0; i < count; i++) {
+    // h + 180, less 360 where that reaches a full turn (exact, as fmod would be)
+    __m128d hs = _mm_add_pd(_mm_loadu_pd(&in[i].h), halfturn);
+    __m128d wrap = _mm_and_pd(_mm_cmpge_pd(hs, fullturn), fullturn);
+    hs = _mm_sub_pd(hs, wrap);
+    // 1 - l, computed as (-l) + 1
+    __m128d la = _mm_add_pd(_mm_xor_pd(_mm_loadu_pd(&in[i].l), lumsign), one);
+    _mm_storeu_pd(&out[i].h, hs);
+    _mm_storeu_pd(&out[i].l, la);
+  }
+#else
+  for (unsigned int i = 0; i < count; i++) {
+    HSLAPixel pixel = in[i];
+    pixel.h = fmod(pixel.h + 180, 360);
+    pixel.l = 1 - pixel.l;
+    out[i] = pixel;
+  }
+#endif
+}
+
+#endif
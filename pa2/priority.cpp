@@ -7,13 +7,14 @@
 *
 *              Ignoring resize costs, any single insertion or removal operation
 *              should cost at most O(n), where n is the number of PixelPoints
-*              stored in the collection.
+*              stored in the collection. Here both cost O(log n).
 *
 * Date:        2022-02-10 02:04
 *
 */
 
 #include "priority.h"
+#include <algorithm>
 #include <assert.h>
 
 using namespace cs221util;
@@ -25,6 +26,7 @@ using namespace std;
 */
 PriorityNeighbours::PriorityNeighbours() {
   refcolor = HSLAPixel();
+  nextseq = 0;
 }
 
 /*
@@ -33,6 +35,7 @@ PriorityNeighbours::PriorityNeighbours() {
 */
 PriorityNeighbours::PriorityNeighbours(HSLAPixel ref) {
   refcolor = ref;
+  nextseq = 0;
 }
 
 /*
@@ -41,7 +44,12 @@ PriorityNeighbours::PriorityNeighbours(HSLAPixel ref) {
 *  POST:  the collection contains p, along with all previously existing items.
 */
 void PriorityNeighbours::Insert(PixelPoint p) {
-  points.push_back(p);
+  Entry entry;
+  entry.dist = p.color.dist(refcolor);
+  entry.seq = nextseq++;
+  entry.point = p;
+  points.push_back(entry);
+  push_heap(points.begin(), points.end(), lowerPriority);
 }
 
 /*
@@ -66,22 +74,13 @@ void PriorityNeighbours::Insert(PixelPoint p) {
 *  priority order and/or accessing the priority element in this specific application!
 */
 PixelPoint PriorityNeighbours::Remove() {
-  double minDist = 99999999;
-  PixelPoint minPoint = PixelPoint();
-  int index = 0;
-  for (int i=0; i<points.size(); i++) {
-    double currDist = points[i].color.dist(refcolor);
-    bool invalidCase = currDist > minDist ||
-      (currDist == minDist && points[i].y > minPoint.y) ||
-      (currDist == minDist && points[i].y == minPoint.y && points[i].x > minPoint.x);
-    if (invalidCase) {
-      continue;
-    }
-    minDist = currDist;
-    minPoint = points[i];
-    index = i;
+  assert(!points.empty());
+  pop_heap(points.begin(), points.end(), lowerPriority);
+  PixelPoint minPoint = points.back().point;
+  points.pop_back();
+  if (points.empty()) {
+    nextseq = 0;
   }
-  points.erase(points.begin()+index);
   return minPoint;
 }
 
@@ -106,5 +105,32 @@ HSLAPixel PriorityNeighbours::GetReferenceColor() const {
 *  POST: refcolor is set to the supplied value
 */
 void PriorityNeighbours::SetReferenceColor(HSLAPixel ref) {
+  bool changed = ref.h != refcolor.h || ref.s != refcolor.s || ref.l != refcolor.l || ref.a != refcolor.a;
   refcolor = ref;
+  if (!changed || points.empty()) {
+    return;
+  }
+  for (size_t i = 0; i < points.size(); i++) {
+    points[i].dist = points[i].point.color.dist(refcolor);
+  }
+  make_heap(points.begin(), points.end(), lowerPriority);
+}
+
+/*
+*  Returns true if a should be removed after b: a is further from the
+*  reference color, or equally far but further down, or equally far and on
+*  the same row but further right. Points with identical keys are removed
+*  most recently inserted first.
+*/
+bool PriorityNeighbours::lowerPriority(const Entry& a, const Entry& b) {
+  if (a.dist != b.dist) {
+    return a.dist > b.dist;
+  }
+  if (a.point.y != b.point.y) {
+    return a.point.y > b.point.y;
+  }
+  if (a.point.x != b.point.x) {
+    return a.point.x > b.point.x;
+  }
+  return a.seq < b.seq;
 }
\ No newline at end of file
@@ -9,6 +9,10 @@
 *              should cost at most O(n), where n is the number of PixelPoints
 *              stored in the collection.
 *
+*              The collection is a binary heap, so insertion and removal cost
+*              O(log n). Each point's distance from the reference color is
+*              cached, and only recomputed when the reference color changes.
+*
 *              You may add your own private functions to support the priority ordering of
 *              the collection contents.
 * 
@@ -86,20 +90,29 @@ class PriorityNeighbours {
 
     /*
     *  Sets the reference color attribute
-    *  POST: refcolor is set to the supplied value
+    *  POST: refcolor is set to the supplied value, and the collection is
+    *        reordered by distance from it if it differs from the old value
     */
     void SetReferenceColor(HSLAPixel ref);
     
   private:
+    /*
+    *  A point in the collection, with its cached priority key.
+    */
+    struct Entry {
+      double dist;       // distance of point.color from refcolor
+      unsigned int seq;  // insertion number, to order points with identical keys
+      PixelPoint point;  // the point itself
+    };
+
     HSLAPixel refcolor;        // reference color for determining priority of the points in the collection
-    vector<PixelPoint> points; // array to store your priority collection.
-                               // You may organize this in any way you like,
-                               // as long as the Remove() function always
-                               // returns the item satisfying the priority condition
+    vector<Entry> points;      // binary heap of the collection, highest priority at the front
+    unsigned int nextseq;      // insertion number of the next point inserted
 
 
   private:
     /* YOU CAN DECLARE YOUR PRIVATE FUNCTIONS HERE */
+    static bool lowerPriority(const Entry& a, const Entry& b);
 
 };
 
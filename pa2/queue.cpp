@@ -1,21 +1,62 @@
 /*
 *  File:        queue.cpp
 *  Description: Implementation of the Queue class.
-*
-*               Complete your implementation in this file
 */
 
+#include <new>
+
+/*
+*  Default constructor. Allocates uninitialized storage for
+*  DEFAULTCAPACITY items.
+*/
+template <class T>
+Queue<T>::Queue()
+{
+  max_items = DEFAULTCAPACITY;
+  items = static_cast<T*>(::operator new(max_items * sizeof(T)));
+  head = 0;
+  num_items = 0;
+}
+
+/*
+*  Destructor. Destroys the remaining items before freeing the storage.
+*/
+template <class T>
+Queue<T>::~Queue()
+{
+  for (size_t i = 0; i < num_items; i++) {
+    Slot(i)->~T();
+  }
+  ::operator delete(items);
+}
+
 /*
 *  Adds the parameter object to the back of the Queue.
 *
-*  NOTE: This fuction should have O(1) behavior over n operations!
-*
 *  PARAM: item -  object to be added to the Queue.
 */
 template <class T>
 void Queue<T>::Enqueue(T const& item)
 {
-  stack_1.Push(item);
+  Emplace(item);
+}
+
+template <class T>
+void Queue<T>::Enqueue(T&& item)
+{
+  Emplace(std::move(item));
+}
+
+/*
+*  Constructs an object at the back of the Queue.
+*/
+template <class T>
+template <class... Args>
+void Queue<T>::Emplace(Args&&... args)
+{
+  Reserve();
+  new (Slot(num_items)) T(std::forward<Args>(args)...);
+  num_items++;
 }
 
 /*
@@ -23,75 +64,86 @@ void Queue<T>::Enqueue(T const& item)
 *  the caller. You may assume that this function is only called
 *  when the Queue is non-empty.
 *
-*  NOTE: This function should have O(1) behavior over n operations!
-*
 *  RETURN: the item that used to be at the front of the Queue.
 */
 template <class T>
 T Queue<T>::Dequeue()
 {
-  if (stack_2.IsEmpty()) {
-    while (!stack_1.IsEmpty()) {
-      stack_2.Push(stack_1.Pop());
-    }
-  }
-  return stack_2.Pop();
+  T* front = Slot(0);
+  T item(std::move(*front));
+  front->~T();
+  head = (head + 1) & (max_items - 1);
+  num_items--;
+  return item;
 }
 
-/*
-*  Adds an element to the ordering structure.
-*
-*  See OrderingStructure::Add()
-*/
 template <class T>
 void Queue<T>::Add(const T& item)
 {
   Enqueue(item);
 }
 
-/*
-*  Removes an element from the ordering structure.
-*
-*  See OrderingStructure::Remove()
-*/
+template <class T>
+void Queue<T>::Add(T&& item)
+{
+  Enqueue(std::move(item));
+}
+
 template <class T>
 T Queue<T>::Remove()
 {
   return Dequeue();
 }
 
-/*
-*  Finds the object at the front of the Queue, and returns it to
-*  the caller. Unlike Dequeue(), this operation does (conceptually!) not alter the
-*  Queue; however, you may need to alter the internal representation of the Queue.
-*  You may assume that this function is only called when the
-*  Queue is non-empty.
-*
-*  NOTE: This function should have O(1) behavior over n operations!
-*
-*  RETURN: the item at the front of the queue.
-*/
 template <class T>
 T Queue<T>::Peek()
 {
-  if (stack_2.IsEmpty()) {
-    while (!stack_1.IsEmpty()) {
-      stack_2.Push(stack_1.Pop());
-    }
-  }
-  return stack_2.Peek();
+  return *Slot(0);
+}
+
+template <class T>
+bool Queue<T>::IsEmpty() const
+{
+  return num_items == 0;
+}
+
+template <class T>
+size_t Queue<T>::Size() const
+{
+  return num_items;
+}
+
+template <class T>
+size_t Queue<T>::Capacity() const
+{
+  return max_items;
+}
+
+template <class T>
+T* Queue<T>::Slot(size_t i) const
+{
+  return items + ((head + i) & (max_items - 1));
 }
 
 /*
-*  Determines if the Queue is empty.
-*
-*  RETURN: true if the stack is empty,
-*          false otherwise.
-* 
-*  NOTE: This function must always run in O(1) time!
+*  Grows the array when it is full. The items are moved to the start of the
+*  new array in queue order, so that head becomes 0.
 */
 template <class T>
-bool Queue<T>::IsEmpty() const
+void Queue<T>::Reserve()
 {
-  return stack_1.IsEmpty() && stack_2.IsEmpty();
+  if (num_items < max_items) {
+    return;
+  }
+  size_t n = max_items * EXPANSIONFACTOR;
+  T* newItems = static_cast<T*>(::operator new(n * sizeof(T)));
+  for (size_t i = 0; i < num_items; i++) {
+    T* old = Slot(i);
+    new (newItems + i) T(std::move(*old));
+    old->~T();
+  }
+  ::operator delete(items);
+  items = newItems;
+  max_items = n;
+  head = 0;
 }
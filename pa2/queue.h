@@ -1,8 +1,6 @@
 /*
 *  File:        queue.h
-*  Description: Definition of the Stack class.
-*
-*               You **should not** modify this file for the PA!
+*  Description: Definition of the Queue class.
 *
 *  Date: 2022-02-11 00:11
 *
@@ -10,41 +8,61 @@
 #ifndef _QUEUE_H_
 #define _QUEUE_H_
 
+#include <stddef.h>
+#include <utility>
+
 #include "orderingstructure.h"
 #include "stack.h"
 
 /*
 *  Queue class: represents a standard queue. Templated to hold elements of
-*  any type. **You must only use the two private member Stacks as your
-*  storage space! You cannot create new private member variables to hold
-*  your objects!** It is up to you to determine how to use them, however.
+*  any type.
 *
-*  Your Queue class should have O(1) running time over n operations
-*  (amortized). There is an obvious solution that takes O(n) running time,
-*  but this will not recieve all of the available points.
+*  Items are stored in a circular buffer: a single array whose capacity is
+*  a power of two, with the front of the queue at index head and the
+*  remaining items following it, wrapping around to the start of the array.
+*  Every operation is O(1), apart from growing the array when it is full,
+*  which doubles its capacity (so O(1) amortized). Items are constructed in
+*  place and moved, never default-constructed or copied, by the Queue.
 *
-*  You **should not** modify this file for the PA!
+*  The original two-stack implementation is StackQueue, in stackqueue.h.
 *
 */
 template <class T>
 class Queue : public OrderingStructure<T> {
   public:
+    /*
+    *  Default constructor: an empty Queue with DEFAULTCAPACITY slots.
+    */
+    Queue();
+
+    /*
+    *  Destructor: destroys any remaining items and frees the array.
+    */
+    ~Queue();
+
+    Queue(const Queue& other) = delete;
+    Queue& operator=(const Queue& other) = delete;
+
     /*
     *  Adds the parameter object to the back of the Queue.
     *
-    *  NOTE: This fuction should have O(1) behavior over n operations!
-    *
     *  PARAM: item -  object to be added to the Queue.
     */
     void Enqueue(const T& item);
+    void Enqueue(T&& item);
+
+    /*
+    *  Constructs an object at the back of the Queue from the given
+    *  constructor arguments.
+    */
+    template <class... Args> void Emplace(Args&&... args);
 
     /*
     *  Removes the object at the front of the Queue, and returns it to
     *  the caller. You may assume that this function is only called
     *  when the Queue is non-empty.
     *
-    *  NOTE: This function should have O(1) behavior over n operations!
-    *
     *  RETURN: the item that used to be at the front of the Queue.
     */
     T Dequeue();
@@ -55,6 +73,7 @@ class Queue : public OrderingStructure<T> {
     *  See OrderingStructure::Add()
     */
     void Add(const T& item);
+    void Add(T&& item);
 
     /*
     *  Removes an element from the ordering structure.
@@ -65,13 +84,10 @@ class Queue : public OrderingStructure<T> {
 
     /*
     *  Finds the object at the front of the Queue, and returns it to
-    *  the caller. Unlike Dequeue(), this operation does (conceptually!) not alter the
-    *  Queue; however, you may need to alter the internal representation of the Queue.
+    *  the caller. Unlike Dequeue(), this operation does not alter the Queue.
     *  You may assume that this function is only called when the
     *  Queue is non-empty.
     *
-    *  NOTE: This function should have O(1) behavior over n operations!
-    *
     *  RETURN: the item at the front of the queue.
     */
     T Peek();
@@ -81,14 +97,36 @@ class Queue : public OrderingStructure<T> {
     *
     *  RETURN: true if the stack is empty,
     *          false otherwise.
-    * 
-    *  NOTE: This function must always run in O(1) time!
     */
     bool IsEmpty() const;
 
+    /*
+    *  Return the number of items in the Queue.
+    */
+    size_t Size() const;
+
+    /*
+    *  Return the number of items the Queue can hold without growing.
+    */
+    size_t Capacity() const;
+
   private:
-    Stack<T> stack_1; /**< One of the two Stack objects you must use. */
-    Stack<T> stack_2; /**< The other of the two Stack objects you must use. */
+    T* items;          // array of max_items slots, of which num_items hold items
+    size_t max_items;  // capacity of items, always a power of two
+    size_t head;       // index of the front item
+    size_t num_items;  // number of items in the Queue
+
+    /*
+    *  Returns the slot holding the i-th item from the front, or the
+    *  slot just past the back if i == num_items.
+    */
+    T* Slot(size_t i) const;
+
+    /*
+    *  Makes room for at least one more item, doubling the capacity and
+    *  moving the items to the front of the new array if it is full.
+    */
+    void Reserve();
 };
 #include "queue.cpp"
 #endif
@@ -1,32 +1,77 @@
 #include "rainbowColorPicker.h"
+#include <algorithm>
 #include <math.h>
 
-using std::pair;
-using std::map;
+using std::max;
+using std::vector;
 
-RainbowColorPicker::RainbowColorPicker(long double freq_) : iter(0), freq(freq_)
+// hue stored for points that have not been picked yet
+#define UNPICKED -1.0
+
+RainbowColorPicker::RainbowColorPicker(long double freq_) : iter(0), freq(freq_), prevwidth(0), prevheight(0)
 {
 }
 
+RainbowColorPicker::RainbowColorPicker(long double freq_, unsigned int width, unsigned int height)
+    : iter(0), freq(freq_), prevwidth(0), prevheight(0)
+{
+    GrowMemo(width, height);
+}
+
 HSLAPixel RainbowColorPicker::operator()(PixelPoint p)
 {
-    PNGmap::iterator stored = prev.find(pair<int, int>(p.x, p.y));
-    if (stored == prev.end()) {
+    // grow only the dimensions p falls outside of
+    if (p.x >= prevwidth || p.y >= prevheight)
+        GrowMemo(p.x >= prevwidth ? max(p.x + 1, prevwidth * 2) : prevwidth,
+                 p.y >= prevheight ? max(p.y + 1, prevheight * 2) : prevheight);
+
+    double& stored = prev[(size_t) p.y * prevwidth + p.x];
+    if (stored == UNPICKED) {
         HSLAPixel next = NextColor();
-        prev[pair<int, int>(p.x, p.y)] = next;
+        stored = next.h;
         return next;
     } else
-        return stored->second;
+        return ColorWithHue(stored);
+}
+
+void RainbowColorPicker::Reset()
+{
+    iter = 0;
+    vector<double>().swap(prev);
+    prevwidth = 0;
+    prevheight = 0;
 }
 
 // http://www.krazydad.com/makecolors.php
 HSLAPixel RainbowColorPicker::NextColor()
 {
-    HSLAPixel ret;
     if (iter * freq > 1) iter = 0;
-    ret.h = (360 * iter * freq);
+    HSLAPixel ret = ColorWithHue(360 * iter * freq);
+    iter++;
+    return ret;
+}
+
+HSLAPixel RainbowColorPicker::ColorWithHue(double hue) const
+{
+    HSLAPixel ret;
+    ret.h = hue;
     ret.s = 1.0;
     ret.l = 0.5;
-    iter++;
     return ret;
 }
+
+/*
+ * Enlarges the memo to at least width x height, keeping the hues picked so far.
+ */
+void RainbowColorPicker::GrowMemo(unsigned int width, unsigned int height)
+{
+    width = max(width, prevwidth);
+    height = max(height, prevheight);
+    vector<double> grown((size_t) width * height, UNPICKED);
+    for (unsigned int y = 0; y < prevheight; y++)
+        std::copy(prev.begin() + (size_t) y * prevwidth, prev.begin() + (size_t) (y + 1) * prevwidth,
+                  grown.begin() + (size_t) y * width);
+    prev.swap(grown);
+    prevwidth = width;
+    prevheight = height;
+}
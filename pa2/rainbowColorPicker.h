@@ -1,9 +1,7 @@
 #ifndef RAINBOWCOLORPICKER_H
 #define RAINBOWCOLORPICKER_H
 
-#include <stdint.h>
-#include <map>
-#include <utility>
+#include <vector>
 #include "colorPicker.h"
 
 /**
@@ -11,7 +9,7 @@
  * given an x and a y coordinate using a rainbow pattern.
  *
  */
-class RainbowColorPicker : public ColorPicker
+class RainbowColorPicker final : public ColorPicker
 {
   public:
     /**
@@ -21,6 +19,16 @@ class RainbowColorPicker : public ColorPicker
      */
     RainbowColorPicker(long double freq_);
 
+    /**
+     * Constructs a new rainbowColorPicker with room in its memo for an
+     * image of the given size, so that filling it never grows the memo.
+     *
+     * @param freq_ Frequency at which to cycle colors
+     * @param width Width of the image to be filled
+     * @param height Height of the image to be filled
+     */
+    RainbowColorPicker(long double freq_, unsigned int width, unsigned int height);
+
     /**
      * Picks the color for pixel (x, y).
      *
@@ -30,13 +38,27 @@ class RainbowColorPicker : public ColorPicker
      */
     virtual HSLAPixel operator()(PixelPoint p);
 
+    /**
+     * Forgets every color picked so far and frees the memo, so that the
+     * picker behaves as if newly constructed.
+     */
+    void Reset();
+
   private:
     HSLAPixel NextColor();
+    HSLAPixel ColorWithHue(double hue) const;
+    void GrowMemo(unsigned int width, unsigned int height);
 
-    typedef std::map<std::pair<int, int>, HSLAPixel> PNGmap;
     size_t iter;
-    PNGmap prev;
     long double freq;
+
+    // Colors already picked, as a dense grid of hues (the other channels
+    // are the same for every color), with UNPICKED where none has been.
+    // The grid grows to cover each point picked, doubling whichever
+    // dimensions the point falls outside of.
+    std::vector<double> prev;
+    unsigned int prevwidth;
+    unsigned int prevheight;
 };
 
 #endif
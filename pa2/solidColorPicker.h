@@ -7,6 +7,7 @@
 #define _SOLIDCOLORPICKER_H_
 
 #include "colorPicker.h"
+#include "pixelspan.h"
 
 /**
  * SolidColorPicker: a functor that determines the color that should be
@@ -14,8 +15,11 @@
  * private helper functions inside this class, as well as local storage, if
  * necessary. Remember to overload a destructor if you need to.
  *
+ * operator() and PickSpan are defined here, and the class is final, so
+ * that a fill templated on SolidColorPicker can inline them and reduce
+ * colouring a pixel to a store of the fill color.
  */
-class SolidColorPicker : public ColorPicker
+class SolidColorPicker final : public ColorPicker
 {
   public:
     /**
@@ -31,7 +35,25 @@ class SolidColorPicker : public ColorPicker
      * Simply returns the same color (used to construct the picker) all
      * of the time.
      */
-    virtual HSLAPixel operator()(PixelPoint p);
+    virtual HSLAPixel operator()(PixelPoint /* p */)
+    {
+        /* sample code */
+      // This function determines the color of the pixel in the output image at point p.
+      // For SolidColorPicker, this simply uses the fixed color
+      // of the member attribute.
+      // Other ColorPickers will need to do some computation to decide what
+      // color to use.
+      return color;
+    }
+
+    /**
+     * Sets every pixel of the run to the fill color.
+     */
+    virtual void PickSpan(unsigned int /* x */, unsigned int /* y */, unsigned int count,
+                          const HSLAPixel* /* originals */, HSLAPixel* out)
+    {
+      FillSpan(out, count, color);
+    }
 
   private:
     /**
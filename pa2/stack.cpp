@@ -5,6 +5,12 @@
 *               Complete your implementation in this file
 */
 
+#include <math.h>
+#include <new>
+#include <stdlib.h>
+#include <type_traits>
+#include <utility>
+
 /*
 *  Default constructor. Remember to initialize any variables you need
 *  and allocate any required memory. The initial size of `items` should
@@ -15,8 +21,12 @@ template <class T>
 Stack<T>::Stack()
 {
   max_items = DEFAULTCAPACITY;
-  items = new T[DEFAULTCAPACITY];
+  items = static_cast<T*>(malloc(DEFAULTCAPACITY * sizeof(T)));
+  if (items == NULL) {
+    throw std::bad_alloc();
+  }
   num_items = 0;
+  min_items = DEFAULTCAPACITY;
 }
 
 /*
@@ -25,7 +35,10 @@ Stack<T>::Stack()
 template <class T>
 Stack<T>::~Stack()
 {
-  delete items;
+  for (size_t i = 0; i < num_items; i++) {
+    items[i].~T();
+  }
+  free(items);
 }
 
 /*
@@ -40,10 +53,24 @@ Stack<T>::~Stack()
 */
 template <class T>
 void Stack<T>::Push(const T& item) {
+  Emplace(item);
+};
+
+template <class T>
+void Stack<T>::Push(T&& item) {
+  Emplace(std::move(item));
+};
+
+/*
+*  Constructs an object on top of the Stack, resizing first exactly as Push does.
+*/
+template <class T>
+template <class... Args>
+void Stack<T>::Emplace(Args&&... args) {
   if (num_items+1 > max_items) {
     Resize(max_items * EXPANSIONFACTOR);
   }
-  items[num_items] = item;
+  new (items + num_items) T(std::forward<Args>(args)...);
   num_items++;
 };
 
@@ -55,14 +82,19 @@ void Stack<T>::Push(const T& item) {
 *  after the item is removed the Stack should be resized to the larger of max_items / EXPANSIONFACTOR,
 *  or DEFAULTCAPACITY.
 *
+*  The stack is never shrunk below the capacity requested by Reserve. Since
+*  a shrink leaves the stack less than half full, it takes at least
+*  max_items / SHRINKRATE further pushes before it grows again.
+*
 *  RETURN: the element that used to be at the top of the Stack.
 */
 template <class T>
 T Stack<T>::Pop() {
   num_items--;
-  T temp = items[num_items];
-  if (num_items < max_items / SHRINKRATE) {
-    Resize(fmax(max_items / EXPANSIONFACTOR, DEFAULTCAPACITY));
+  T temp(std::move(items[num_items]));
+  items[num_items].~T();
+  if (num_items < max_items / SHRINKRATE && max_items > min_items) {
+    Resize(fmax(fmax(max_items / EXPANSIONFACTOR, DEFAULTCAPACITY), min_items));
   }
   return temp;
 };
@@ -77,6 +109,12 @@ void Stack<T>::Add(const T& item)
   Push(item);
 }
 
+template <class T>
+void Stack<T>::Add(T&& item)
+{
+  Push(std::move(item));
+}
+
 /*
 *  Removes an element from the ordering structure. You may assume
 *  that this function is only called when the ordering structure is
@@ -134,20 +172,59 @@ size_t Stack<T>::Size() const {
   return num_items;
 };
 
+/*
+*  Grows the stack to hold at least n items, and stops Pop from shrinking
+*  it below n.
+*/
+template <class T>
+void Stack<T>::Reserve(size_t n) {
+  min_items = fmax(n, DEFAULTCAPACITY);
+  if (min_items > max_items) {
+    Resize(min_items);
+  }
+};
+
+/*
+*  Shrinks the stack to hold just its items, or DEFAULTCAPACITY if larger,
+*  and cancels any earlier Reserve.
+*/
+template <class T>
+void Stack<T>::ShrinkToFit() {
+  min_items = DEFAULTCAPACITY;
+  size_t n = fmax(num_items, DEFAULTCAPACITY);
+  if (n != max_items) {
+    Resize(n);
+  }
+};
+
 /*
 *  Resize the the member variable `items`.
 *  The minimum size is the number of items in the Stack.
 *  Don't forget to free up any memory that is no longer used.
+*  Trivially copyable items are moved by realloc, which can often extend
+*  the block in place; anything else is move-constructed into new storage.
 *  PRE: n >= num_items, i.e. the new size has room for all items in the structure
 *  PARAM: n - the capacity of the stack after resizing
 */
 template <class T>
 void Stack<T>::Resize(size_t n) {
-  T* newItems = new T[n];
-  max_items = n;
-  for(size_t i=0; i<num_items; i++) {
-    newItems[i] = items[i];
+  T* newItems;
+  if (std::is_trivially_copyable<T>::value) {
+    newItems = static_cast<T*>(realloc(static_cast<void*>(items), n * sizeof(T)));
+    if (newItems == NULL) {
+      throw std::bad_alloc();
+    }
+  } else {
+    newItems = static_cast<T*>(malloc(n * sizeof(T)));
+    if (newItems == NULL) {
+      throw std::bad_alloc();
+    }
+    for (size_t i = 0; i < num_items; i++) {
+      new (newItems + i) T(std::move(items[i]));
+      items[i].~T();
+    }
+    free(items);
   }
-  delete[] items;
   items = newItems;
+  max_items = n;
 };
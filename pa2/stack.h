@@ -2,8 +2,11 @@
 *  File:        stack.h
 *  Description: Definition of the Stack class.
 *
-*               You **should not** modify this file for the PA!
-* 
+*               Items live in uninitialized storage from malloc: they are
+*               constructed in place as they are pushed and destroyed as they
+*               are popped, and moved (or, for trivially copyable types,
+*               realloc'd) rather than copied when the storage is resized.
+*
 *  Date: 2022-02-10 22:27
 *
 */
@@ -15,6 +18,8 @@
 #define EXPANSIONFACTOR 2 // Factor to multiply or divide current size by when resizing.
 #define SHRINKRATE 4      // When the size of the array is less than equal 1 over this value the array should resize
 
+#include <stddef.h>
+
 #include "orderingstructure.h"
 
 template <class T>
@@ -30,12 +35,21 @@ class Stack : public OrderingStructure<T> {
     */
     ~Stack();
 
+    Stack(const Stack& other) = delete;
+    Stack& operator=(const Stack& other) = delete;
+
     /*
     *  Adds the parameter object to the top of the Stack
     *  PARAM: item - the object to be added to the Stack
     *  POST:  the Stack contains newitem at the top, as its most recently added item.
     */
     void Push(const T& item);
+    void Push(T&& item);
+
+    /*
+    *  Constructs an object on top of the Stack from the given constructor arguments.
+    */
+    template <class... Args> void Emplace(Args&&... args);
 
     /*
     *  Removes the object on top of the Stack, and returns it.
@@ -49,6 +63,7 @@ class Stack : public OrderingStructure<T> {
     *  See OrderingStructure::Add()
     */
     void Add(const T& item);
+    void Add(T&& item);
 
     /*
     *  Removes an element from the ordering structure. You may assume
@@ -85,6 +100,18 @@ class Stack : public OrderingStructure<T> {
     */
     size_t Size() const;
 
+    /*
+    *  Grows the stack to hold at least n items, and stops Pop from shrinking
+    *  it below n, so that a known workload never resizes.
+    */
+    void Reserve(size_t n);
+
+    /*
+    *  Shrinks the stack to hold just its items (or DEFAULTCAPACITY, if
+    *  larger), and cancels any earlier Reserve.
+    */
+    void ShrinkToFit();
+
   private:
     /*
     *  The maximum number of items the stack can store without a resize
@@ -96,6 +123,11 @@ class Stack : public OrderingStructure<T> {
     */
     size_t num_items;
 
+    /*
+    *  The capacity Pop will not shrink the stack below, set by Reserve
+    */
+    size_t min_items;
+
     /*
     *  The dynamic array representing our Stack
     */
@@ -1,9 +1,14 @@
 #define CATCH_CONFIG_MAIN
 #include "cs221util/catch.hpp"
 #include <limits.h>
+#include <math.h>
+#include <memory>
 #include <vector>
 #include <sys/stat.h>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <string>
 #include "cs221util/PNG.h"
 #include "cs221util/HSLAPixel.h"
 #include "filler.h"
@@ -12,6 +17,8 @@
 #include "negativeColorPicker.h"
 #include "censorColorPicker.h"
 #include "rainbowColorPicker.h"
+#include "layeredColorPicker.h"
+#include "components.h"
 
 using namespace std;
 using namespace cs221util;
@@ -89,6 +96,147 @@ PNG testColorPicker(ColorPicker& picker)
     return img;
 }
 
+/*
+*  A GIF file as read back by ReadGif: its logical screen size, the rectangle
+*  of every frame, and the palette index of every pixel once all frames have
+*  been drawn over one another.
+*/
+struct DecodedGif {
+    bool ok;
+    unsigned int width;
+    unsigned int height;
+    vector<unsigned int> frameRects; // left, top, width and height of each frame
+    vector<unsigned char> canvas;    // palette index of every pixel, row-major
+};
+
+/*
+*  Decodes the LZW-compressed palette indices of one GIF frame, appending
+*  them to out. Returns false if the data is not a valid code stream.
+*/
+bool DecodeLzw(vector<unsigned char> const& data, unsigned int minCodeSize, vector<unsigned char>& out)
+{
+    unsigned int clear = 1u << minCodeSize;
+    unsigned int end = clear + 1;
+    vector<vector<unsigned char>> table;
+    unsigned int codeSize = minCodeSize + 1;
+    int prev = -1;
+    size_t bit = 0;
+    while (bit + codeSize <= data.size() * 8) {
+        unsigned int code = 0;
+        for (unsigned int i = 0; i < codeSize; i++, bit++) {
+            code |= ((data[bit / 8] >> (bit % 8)) & 1u) << i;
+        }
+        if (code == clear || table.empty()) {
+            if (code != clear) return false;
+            table.assign(clear + 2, vector<unsigned char>());
+            for (unsigned int i = 0; i < clear; i++) table[i].push_back((unsigned char) i);
+            codeSize = minCodeSize + 1;
+            prev = -1;
+            continue;
+        }
+        if (code == end) return true;
+
+        vector<unsigned char> entry;
+        if (code < table.size() && code != clear && code != end) {
+            entry = table[code];
+        } else if (code == table.size() && prev >= 0) {
+            entry = table[prev];
+            entry.push_back(table[prev][0]);
+        } else {
+            return false;
+        }
+        out.insert(out.end(), entry.begin(), entry.end());
+        if (prev >= 0 && table.size() < 4096) {
+            vector<unsigned char> added = table[prev];
+            added.push_back(entry[0]);
+            table.push_back(added);
+            if (table.size() == (1u << codeSize) && codeSize < 12) codeSize++;
+        }
+        prev = code;
+    }
+    return false;
+}
+
+/*
+*  Reads back a GIF written by GifWriter: a global palette, then extensions
+*  and frames until the trailer. Each frame is drawn over the frames before it.
+*/
+DecodedGif ReadGif(string const& filename)
+{
+    DecodedGif gif;
+    gif.ok = false;
+    gif.width = gif.height = 0;
+    ifstream in(filename.c_str(), ios::binary);
+    vector<unsigned char> bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    size_t pos = 0;
+    auto word = [&](size_t at) { return (unsigned int) (bytes[at] | bytes[at + 1] << 8); };
+
+    if (bytes.size() < 13 || string(bytes.begin(), bytes.begin() + 6) != "GIF89a") return gif;
+    gif.width = word(6);
+    gif.height = word(8);
+    gif.canvas.assign((size_t) gif.width * gif.height, 0);
+    pos = 13;
+    if (bytes[10] & 0x80) pos += 3 * (2u << (bytes[10] & 7));
+
+    while (pos < bytes.size()) {
+        unsigned char kind = bytes[pos++];
+        if (kind == 0x3B) {
+            gif.ok = pos == bytes.size();
+            return gif;
+        }
+        if (kind == 0x21) {
+            pos++; // extension label
+            while (pos < bytes.size() && bytes[pos] != 0) pos += bytes[pos] + 1;
+            pos++;
+            continue;
+        }
+        if (kind != 0x2C || pos + 10 > bytes.size()) return gif;
+
+        unsigned int left = word(pos), top = word(pos + 2), w = word(pos + 4), h = word(pos + 6);
+        pos += 9; // descriptor, with no local palette
+        unsigned int minCodeSize = bytes[pos++];
+        vector<unsigned char> data;
+        while (pos < bytes.size() && bytes[pos] != 0) {
+            data.insert(data.end(), bytes.begin() + pos + 1, bytes.begin() + pos + 1 + bytes[pos]);
+            pos += bytes[pos] + 1;
+        }
+        pos++;
+
+        vector<unsigned char> indices;
+        if (left + w > gif.width || top + h > gif.height || !DecodeLzw(data, minCodeSize, indices)
+            || indices.size() != (size_t) w * h) {
+            return gif;
+        }
+        for (unsigned int y = 0; y < h; y++) {
+            for (unsigned int x = 0; x < w; x++) {
+                gif.canvas[(size_t) (top + y) * gif.width + left + x] = indices[(size_t) y * w + x];
+            }
+        }
+        gif.frameRects.push_back(left);
+        gif.frameRects.push_back(top);
+        gif.frameRects.push_back(w);
+        gif.frameRects.push_back(h);
+    }
+    return gif;
+}
+
+/*
+*  Returns true if every pixel of a decoded GIF has the palette index of the
+*  same pixel of img.
+*/
+bool GifMatches(DecodedGif const& gif, PNG const& img)
+{
+    if (!gif.ok || gif.width != img.width() || gif.height != img.height()) return false;
+    for (unsigned int y = 0; y < img.height(); y++) {
+        for (unsigned int x = 0; x < img.width(); x++) {
+            if (gif.canvas[(size_t) y * img.width() + x] != GifWriter::PaletteIndex(*img.getPixel(x, y))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 TEST_CASE("colorPicker::basic solid","[weight=1][part=colorPicker]"){
 
     HSLAPixel px;
@@ -142,6 +290,82 @@ TEST_CASE("colorPicker::basic censor", "[weight=1][part=colorPicker]") {
   REQUIRE(result == expected);
 }
 
+bool CloseColor(HSLAPixel a, HSLAPixel b) {
+  return fabs(a.h - b.h) < 1e-6 && fabs(a.s - b.s) < 1e-9 && fabs(a.l - b.l) < 1e-9 && fabs(a.a - b.a) < 1e-9;
+}
+
+TEST_CASE("colorPicker::censor shared integral image", "[weight=1][part=colorPicker]") {
+
+  PNG imgtest;
+  imgtest.readFromFile(CENSORTESTIMAGE);
+  shared_ptr<const IntegralImage> sums = make_shared<IntegralImage>(imgtest);
+  PixelPoint center(CENSORX, CENSORY, HSLAPixel());
+
+  // block widths that do and do not divide the image dimensions
+  unsigned int widths[] = { 1, 3, CENSORWIDTH, 17 };
+  for (unsigned int w : widths) {
+    CensorColorPicker eager(w, center, CENSORRADIUS, imgtest, sums);
+    CensorColorPicker lazy(w, center, CENSORRADIUS, imgtest, sums, true);
+    bool same = true;
+    for (unsigned int y = 0; y < imgtest.height(); y++) {
+      for (unsigned int x = 0; x < imgtest.width(); x++) {
+        PixelPoint p(x, y, HSLAPixel());
+        HSLAPixel expected = *imgtest.getPixel(x, y);
+        double dx = (double) x - CENSORX, dy = (double) y - CENSORY;
+        if (sqrt(dx * dx + dy * dy) <= CENSORRADIUS) {
+          // average the block directly
+          double h = 0, s = 0, l = 0, a = 0;
+          int count = 0;
+          for (unsigned int by = y - y % w; by < y - y % w + w && by < imgtest.height(); by++) {
+            for (unsigned int bx = x - x % w; bx < x - x % w + w && bx < imgtest.width(); bx++) {
+              HSLAPixel* px = imgtest.getPixel(bx, by);
+              h += px->h; s += px->s; l += px->l; a += px->a;
+              count++;
+            }
+          }
+          expected = HSLAPixel(h / count, s / count, l / count, a / count);
+        }
+        HSLAPixel fromEager = eager(p);
+        HSLAPixel fromLazy = lazy(p);
+        same = same && CloseColor(fromEager, expected) && CloseColor(fromLazy, expected);
+      }
+    }
+    REQUIRE(same);
+  }
+
+  // a table summed from an image of another size is ignored
+  PNG smaller(imgtest.width() / 2, imgtest.height() / 2);
+  shared_ptr<const IntegralImage> wrong = make_shared<IntegralImage>(smaller);
+  CensorColorPicker mismatched(CENSORWIDTH, center, CENSORRADIUS, imgtest, wrong);
+  CensorColorPicker fresh(CENSORWIDTH, center, CENSORRADIUS, imgtest);
+  REQUIRE(testColorPicker(mismatched) == testColorPicker(fresh));
+}
+
+TEST_CASE("colorPicker::shared image handles", "[weight=1][part=colorPicker]") {
+
+  PNG imgtest;
+  imgtest.readFromFile(CENSORTESTIMAGE);
+  PNG imgother;
+  imgother.readFromFile(IMGTILEOTHERIMAGE);
+  PixelPoint center(CENSORX, CENSORY, HSLAPixel());
+
+  // pickers built from one handle share its pixels, and pick what copying pickers pick
+  ImageHandle source = ShareImage(imgtest);
+  ImageHandle tile = ShareImage(imgother);
+  NegativeColorPicker sharedNegative(source);
+  CensorColorPicker sharedCensor(CENSORWIDTH, center, CENSORRADIUS, source);
+  ImageTileColorPicker sharedTile(tile);
+  REQUIRE(source.use_count() == 3);
+  REQUIRE(tile.use_count() == 2);
+
+  NegativeColorPicker copiedNegative(imgtest);
+  CensorColorPicker copiedCensor(CENSORWIDTH, center, CENSORRADIUS, imgtest);
+  ImageTileColorPicker copiedTile(imgother);
+  REQUIRE(testColorPicker(sharedNegative) == testColorPicker(copiedNegative));
+  REQUIRE(testColorPicker(sharedCensor) == testColorPicker(copiedCensor));
+  REQUIRE(testColorPicker(sharedTile) == testColorPicker(copiedTile));
+}
+
 TEST_CASE("colorPicker::basic rainbow","[weight=1][part=colorPicker]"){
     RainbowColorPicker rainPicker(1.0/1000.0);
 
@@ -152,6 +376,101 @@ TEST_CASE("colorPicker::basic rainbow","[weight=1][part=colorPicker]"){
 }
 
 
+TEST_CASE("colorPicker::rainbow memo","[weight=1][part=colorPicker]"){
+    RainbowColorPicker grown(RAINFREQ);
+    RainbowColorPicker sized(RAINFREQ, FUNCTORTESTWIDTH, FUNCTORTESTHEIGHT);
+
+    // pick points out of order, so the grown memo is resized several times
+    vector<PixelPoint> points;
+    for (int i = 0; i < 500; i++) {
+        points.push_back(PixelPoint((i * 37) % FUNCTORTESTWIDTH, (i * 91) % FUNCTORTESTHEIGHT, HSLAPixel()));
+    }
+    vector<HSLAPixel> first;
+    for (size_t i = 0; i < points.size(); i++) {
+        first.push_back(grown(points[i]));
+        REQUIRE(sized(points[i]).h == first[i].h);
+    }
+    // points already picked keep their colors
+    for (size_t i = 0; i < points.size(); i++) {
+        REQUIRE(grown(points[i]).h == first[i].h);
+    }
+
+    // after a reset the picker starts over
+    grown.Reset();
+    RainbowColorPicker fresh(RAINFREQ);
+    for (size_t i = points.size(); i-- > 0; ) {
+        REQUIRE(grown(points[i]).h == fresh(points[i]).h);
+    }
+}
+
+/*
+*  Returns true if picker.PickSpan picks exactly the colors operator() does,
+*  for runs of assorted lengths covering every row of img, both into a
+*  separate array and in place.
+*/
+bool SpansMatch(ColorPicker& picker, PNG& img) {
+  unsigned int lengths[] = { 1, 5, 13, 29, 64 };
+  bool same = true;
+  vector<HSLAPixel> out(img.width());
+  for (unsigned int y = 0; y < img.height(); y++) {
+    HSLAPixel* row = img.getPixel(0, y);
+    vector<HSLAPixel> inplace(row, row + img.width());
+    unsigned int x = 0;
+    for (int i = 0; x < img.width(); i++) {
+      unsigned int count = min(lengths[(i + y) % 5], img.width() - x);
+      picker.PickSpan(x, y, count, row + x, &out[x]);
+      picker.PickSpan(x, y, count, &inplace[x], &inplace[x]);
+      x += count;
+    }
+    for (x = 0; x < img.width(); x++) {
+      HSLAPixel expected = picker(PixelPoint(x, y, *img.getPixel(x, y)));
+      same = same && out[x].h == expected.h && out[x].s == expected.s && out[x].l == expected.l && out[x].a == expected.a;
+      same = same && inplace[x].h == expected.h && inplace[x].s == expected.s && inplace[x].l == expected.l && inplace[x].a == expected.a;
+    }
+  }
+  return same;
+}
+
+TEST_CASE("colorPicker::spans","[weight=1][part=colorPicker]"){
+
+    PNG img;
+    img.readFromFile(CENSORTESTIMAGE);
+    PNG other;
+    other.readFromFile(IMGTILEOTHERIMAGE);
+
+    SolidColorPicker solidPicker(HSLAPixel(100., 1.0, 0.5));
+    REQUIRE(SpansMatch(solidPicker, img));
+
+    NegativeColorPicker negativePicker(img);
+    REQUIRE(SpansMatch(negativePicker, img));
+
+    // a tile narrower than some runs, so runs wrap around it
+    PNG tile = other;
+    tile.resize(23, 17);
+    ImageTileColorPicker tilePicker(tile);
+    REQUIRE(SpansMatch(tilePicker, img));
+    ImageTileColorPicker otherPicker(other);
+    REQUIRE(SpansMatch(otherPicker, img));
+
+    // circles inside the image, past its left and top edges, and covering it
+    shared_ptr<const IntegralImage> sums = make_shared<IntegralImage>(img);
+    CensorColorPicker censorPicker(CENSORWIDTH, PixelPoint(CENSORX, CENSORY, HSLAPixel()), CENSORRADIUS, img);
+    REQUIRE(SpansMatch(censorPicker, img));
+    CensorColorPicker cornerPicker(7, PixelPoint(3, 2, HSLAPixel()), 40, img, sums, true);
+    REQUIRE(SpansMatch(cornerPicker, img));
+    CensorColorPicker widePicker(17, PixelPoint(img.width() / 2, img.height() / 2, HSLAPixel()), img.width() * 2, img, sums);
+    REQUIRE(SpansMatch(widePicker, img));
+
+    // the default loops over operator()
+    RainbowColorPicker rainPicker(RAINFREQ);
+    RainbowColorPicker rainCopy(RAINFREQ);
+    HSLAPixel row[10];
+    rainPicker.PickSpan(5, 5, 10, row, row);
+    for (unsigned int i = 0; i < 10; i++) {
+        REQUIRE(row[i].h == rainCopy(PixelPoint(5 + i, 5, HSLAPixel())).h);
+    }
+}
+
 TEST_CASE("fill::basic solid dfs","[weight=1][part=fill]"){
     
     HSLAPixel px(100., 1.0, 0.5);
@@ -197,6 +516,285 @@ TEST_CASE("fill::basic solid bfs","[weight=1][part=fill]"){
 }
 
 
+TEST_CASE("fill::templated picker","[weight=1][part=fill]"){
+
+    HSLAPixel px(100., 1.0, 0.5);
+    SolidColorPicker solidPicker(px);
+
+    filler::FillerConfig solidconfig;
+    solidconfig.img.readFromFile(SOLIDTESTIMAGE);
+    solidconfig.frameFreq = SOLIDFRAMEFREQ;
+    solidconfig.tolerance = SOLIDTOLERANCE;
+    solidconfig.seedpoint = PixelPoint(SOLIDX, SOLIDY, *solidconfig.img.getPixel(SOLIDX, SOLIDY));
+    solidconfig.picker = NULL;
+
+    animation anim;
+    anim = filler::FillBFS(solidconfig, solidPicker);
+    PNG result = anim.write("images/bfssolidtemplated.gif");
+
+    PNG expected; expected.readFromFile("soln_images/bfssolid.png");
+    REQUIRE(result==expected);
+}
+
+TEST_CASE("fill::tolerance mask","[weight=1][part=fill]"){
+
+    // the test image tiled 3 x 2, large enough to be built on several
+    // threads, and cropped to an odd size, so the last bitmap word is
+    // partly past the image
+    PNG leaf;
+    leaf.readFromFile(CENSORTESTIMAGE);
+    PNG img(leaf.width() * 3 - 3, leaf.height() * 2 - 1);
+    for (unsigned int y = 0; y < img.height(); y++) {
+        for (unsigned int x = 0; x < img.width(); x++) {
+            *img.getPixel(x, y) = *leaf.getPixel(x % leaf.width(), y % leaf.height());
+        }
+    }
+    HSLAPixel seed = *img.getPixel(CENSORX, CENSORY);
+
+    double tolerances[] = { 0.0, SOLIDTOLERANCE, CENSORTOLERANCE, 0.5 };
+    for (double tolerance : tolerances) {
+        for (unsigned int threads = 1; threads <= 3; threads++) {
+            ToleranceMask mask(img, seed, tolerance, threads);
+            bool same = true;
+            for (unsigned int y = 0; y < img.height(); y++) {
+                for (unsigned int x = 0; x < img.width(); x++) {
+                    same = same && mask.Get(x, y) == (img.getPixel(x, y)->dist(seed) <= tolerance);
+                }
+            }
+            REQUIRE(same);
+            REQUIRE(mask.Matches(seed, tolerance));
+            REQUIRE(!mask.Matches(seed, tolerance + 1));
+        }
+    }
+}
+
+TEST_CASE("fill::shared tolerance mask","[weight=1][part=fill]"){
+
+    PNG png;
+    png.readFromFile(SOLIDTESTIMAGE);
+    ImageHandle original = ShareImage(png);
+    HSLAPixel seedcolor = *original->getPixel(SOLIDX, SOLIDY);
+    shared_ptr<const ToleranceMask> mask = make_shared<ToleranceMask>(original, seedcolor, SOLIDTOLERANCE);
+
+    // one mask serves fills of copies of the image with different pickers and orders
+    SolidColorPicker solidPicker(HSLAPixel(100., 1.0, 0.5));
+    NegativeColorPicker negativePicker(original);
+    ColorPicker* pickers[] = { &solidPicker, &negativePicker };
+    const char* expected[] = { "soln_images/dfssolid.png", "soln_images/bfsnegative.png" };
+    filler::FillerConfig config;
+    for (int i = 0; i < 2; i++) {
+        config.img = *original;
+        config.source = original;
+        config.frameFreq = SOLIDFRAMEFREQ;
+        config.tolerance = SOLIDTOLERANCE;
+        config.seedpoint = PixelPoint(SOLIDX, SOLIDY, seedcolor);
+        config.picker = pickers[i];
+        config.mask = mask;
+        REQUIRE(filler::sharedMask(config) == mask.get());
+
+        animation anim;
+        anim = i == 0 ? filler::FillDFS(config) : filler::FillBFS(config);
+        PNG result = anim.write("images/sharedmask.gif");
+        PNG expectedimg; expectedimg.readFromFile(expected[i]);
+        REQUIRE(result == expectedimg);
+    }
+
+    // the mask is not used for an image of the same size it was not built
+    // from, nor when the fill's image has no source
+    PNG edited = *original;
+    edited.getPixel(SOLIDX, SOLIDY)->l = 1 - edited.getPixel(SOLIDX, SOLIDY)->l;
+    config.img = edited;
+    config.source = ShareImage(edited);
+    REQUIRE(filler::sharedMask(config) == nullptr);
+    config.source = nullptr;
+    REQUIRE(filler::sharedMask(config) == nullptr);
+
+    // nor is a mask built from a PNG rather than an ImageHandle
+    config.img = *original;
+    config.source = original;
+    config.mask = make_shared<ToleranceMask>(*original, seedcolor, SOLIDTOLERANCE);
+    REQUIRE(filler::sharedMask(config) == nullptr);
+}
+
+TEST_CASE("fill::negative viewing the filled image","[weight=1][part=fill]"){
+
+    filler::FillerConfig negativeconfig;
+    negativeconfig.img.readFromFile(NEGATIVETESTIMAGE);
+    negativeconfig.frameFreq = NEGATIVEFRAMEFREQ;
+    negativeconfig.tolerance = NEGATIVETOLERANCE;
+    negativeconfig.seedpoint = PixelPoint(NEGATIVEX, NEGATIVEY, *negativeconfig.img.getPixel(NEGATIVEX, NEGATIVEY));
+
+    // the picker reads each pixel of config.img just before the fill overwrites it
+    NegativeColorPicker negativePicker(ViewImage(negativeconfig.img));
+    negativeconfig.picker = &negativePicker;
+
+    animation anim;
+    anim = filler::FillBFS(negativeconfig);
+    PNG result = anim.write("images/bfsnegativeview.gif");
+
+    PNG expected; expected.readFromFile("soln_images/bfsnegative.png");
+    REQUIRE(result==expected);
+}
+
+/*
+*  Labels the components of img one at a time with a breadth-first search
+*  from each unlabelled pixel in row-major order.
+*/
+vector<uint32_t> SearchComponents(PNG& img, double tolerance, vector<RegionStats>& regions) {
+    vector<uint32_t> labels((size_t) img.width() * img.height(), UINT32_MAX);
+    for (unsigned int sy = 0; sy < img.height(); sy++) {
+        for (unsigned int sx = 0; sx < img.width(); sx++) {
+            if (labels[(size_t) sy * img.width() + sx] != UINT32_MAX) {
+                continue;
+            }
+            uint32_t label = regions.size();
+            RegionStats stats = { 0, sx, sy, sx, sy, HSLAPixel(0, 0, 0, 0) };
+            Queue<PixelPoint> frontier;
+            labels[(size_t) sy * img.width() + sx] = label;
+            frontier.Enqueue(PixelPoint(sx, sy, *img.getPixel(sx, sy)));
+            while (!frontier.IsEmpty()) {
+                PixelPoint p = frontier.Dequeue();
+                stats.area++;
+                stats.left = min(stats.left, p.x);
+                stats.right = max(stats.right, p.x);
+                stats.top = min(stats.top, p.y);
+                stats.bottom = max(stats.bottom, p.y);
+                stats.mean.h += p.color.h; stats.mean.s += p.color.s;
+                stats.mean.l += p.color.l; stats.mean.a += p.color.a;
+                int dx[] = { 0, 0, -1, 1 };
+                int dy[] = { -1, 1, 0, 0 };
+                for (int d = 0; d < 4; d++) {
+                    unsigned int nx = p.x + dx[d], ny = p.y + dy[d];
+                    if (nx >= img.width() || ny >= img.height() || labels[(size_t) ny * img.width() + nx] != UINT32_MAX) {
+                        continue;
+                    }
+                    HSLAPixel color = *img.getPixel(nx, ny);
+                    if (p.color.dist(color) <= tolerance) {
+                        labels[(size_t) ny * img.width() + nx] = label;
+                        frontier.Enqueue(PixelPoint(nx, ny, color));
+                    }
+                }
+            }
+            stats.mean = HSLAPixel(stats.mean.h / stats.area, stats.mean.s / stats.area,
+                                   stats.mean.l / stats.area, stats.mean.a / stats.area);
+            regions.push_back(stats);
+        }
+    }
+    return labels;
+}
+
+TEST_CASE("components::labels and stats","[weight=1][part=components]"){
+
+    PNG leaf;
+    leaf.readFromFile(CENSORTESTIMAGE);
+    // the test image tiled 3 x 2, so that several strips are labelled
+    PNG tiled(leaf.width() * 3 - 5, leaf.height() * 2 - 7);
+    for (unsigned int y = 0; y < tiled.height(); y++) {
+        for (unsigned int x = 0; x < tiled.width(); x++) {
+            *tiled.getPixel(x, y) = *leaf.getPixel(x % leaf.width(), y % leaf.height());
+        }
+    }
+
+    PNG* images[] = { &leaf, &tiled };
+    double tolerances[] = { 0.0, CENSORTOLERANCE / 8, CENSORTOLERANCE };
+    for (PNG* img : images) {
+        for (double tolerance : tolerances) {
+            vector<RegionStats> expected;
+            vector<uint32_t> expectedlabels = SearchComponents(*img, tolerance, expected);
+            for (unsigned int threads = 1; threads <= 4; threads++) {
+                ComponentLabels components(*img, tolerance, threads);
+                REQUIRE(components.Labels() == expectedlabels);
+                REQUIRE(components.RegionCount() == expected.size());
+                bool same = true;
+                for (size_t i = 0; i < expected.size(); i++) {
+                    RegionStats const& stats = components.Region(i);
+                    same = same && stats.area == expected[i].area && stats.left == expected[i].left &&
+                           stats.top == expected[i].top && stats.right == expected[i].right &&
+                           stats.bottom == expected[i].bottom && CloseColor(stats.mean, expected[i].mean);
+                }
+                REQUIRE(same);
+            }
+        }
+    }
+}
+
+TEST_CASE("components::mean image","[weight=1][part=components]"){
+
+    // two halves of different colours, the right one split by a line
+    PNG img(40, 30);
+    for (unsigned int y = 0; y < img.height(); y++) {
+        for (unsigned int x = 0; x < img.width(); x++) {
+            *img.getPixel(x, y) = x < 20 ? HSLAPixel(100., 0.5, 0.4 + 0.001 * (x % 2)) : HSLAPixel(200., 0.8, 0.6);
+        }
+    }
+    for (unsigned int x = 20; x < img.width(); x++) {
+        *img.getPixel(x, 10) = HSLAPixel(0., 1.0, 0.1);
+    }
+
+    ComponentLabels components(img, 0.01);
+    REQUIRE(components.RegionCount() == 4);
+    REQUIRE(components.Region(0).area == 20 * 30);
+    REQUIRE(components.Region(0).mean.l == Approx(0.4005));
+    REQUIRE(components.Region(1).area == 20 * 10);
+    REQUIRE(components.Region(2).area == 20);
+    REQUIRE(components.Region(3).area == 20 * 19);
+    REQUIRE(components.Label(39, 29) == 3);
+    REQUIRE(components.Region(3).top == 11);
+    REQUIRE(components.Region(3).left == 20);
+
+    PNG means = components.MeanImage();
+    REQUIRE(*means.getPixel(0, 0) == components.Region(0).mean);
+    REQUIRE(*means.getPixel(25, 10) == HSLAPixel(0., 1.0, 0.1));
+}
+
+TEST_CASE("fill::layered censor over image tile","[weight=1][part=fill]"){
+
+    PNG tiletest;
+    PNG tileother;
+    tiletest.readFromFile(IMGTILETESTIMAGE);
+    tileother.readFromFile(IMGTILEOTHERIMAGE);
+    ImageTileColorPicker tilePicker(tileother);
+    PixelPoint center(IMGTILEX, IMGTILEY, HSLAPixel());
+    CensorColorPicker censorPicker(CENSORWIDTH, center, CENSORRADIUS, tiletest);
+    LayeredColorPicker<CensorColorPicker, ImageTileColorPicker> layeredPicker(censorPicker, tilePicker);
+
+    filler::FillerConfig tileconfig;
+    tileconfig.img = tiletest;
+    tileconfig.frameFreq = IMGTILEFRAMEFREQ;
+    tileconfig.tolerance = IMGTILETOLERANCE;
+    tileconfig.seedpoint = PixelPoint(IMGTILEX, IMGTILEY, *tileconfig.img.getPixel(IMGTILEX, IMGTILEY));
+    tileconfig.picker = &layeredPicker;
+
+    // fills change config.img, so each fill gets its own copy
+    filler::FillerConfig templatedconfig = tileconfig;
+    filler::FillerConfig regionconfig = tileconfig;
+
+    // the templated fill agrees with the fill through config.picker
+    PNG result = filler::FillDFS(tileconfig).write("images/dfslayered.gif");
+    PNG templated = filler::FillDFS(templatedconfig, layeredPicker).write("images/dfslayeredtemplated.gif");
+    REQUIRE(result == templated);
+
+    // and each filled pixel comes from the censor inside its circle, or the tile outside it
+    HSLAPixel marker(0., 0., 0., 0.5);
+    SolidColorPicker markerPicker(marker);
+    PNG region = filler::FillDFS(regionconfig, markerPicker).write("images/dfslayeredregion.gif");
+    bool same = true;
+    int covered = 0;
+    for (unsigned int y = 0; y < tiletest.height(); y++) {
+        for (unsigned int x = 0; x < tiletest.width(); x++) {
+            PixelPoint p(x, y, HSLAPixel());
+            HSLAPixel expected = *tiletest.getPixel(x, y);
+            if (region.getPixel(x, y)->a == marker.a) {
+                expected = censorPicker.Covers(p) ? censorPicker(p) : tilePicker(p);
+                covered += censorPicker.Covers(p) ? 1 : 0;
+            }
+            same = same && *result.getPixel(x, y) == expected;
+        }
+    }
+    REQUIRE(same);
+    REQUIRE(covered > 0);
+}
+
 TEST_CASE("fill::basic image tile dfs","[weight=1][part=fill]"){
     
     PNG tiletest;
@@ -374,3 +972,189 @@ TEST_CASE("fill::basic rainbow bfs","[weight=1][part=fill]"){
 
 }
 
+TEST_CASE("fill::scanline solid","[weight=1][part=fill]"){
+
+    HSLAPixel px(100., 1.0, 0.5);
+    SolidColorPicker solidPicker(px);
+
+    filler::FillerConfig solidconfig;
+    solidconfig.img.readFromFile(SOLIDTESTIMAGE);
+    solidconfig.frameFreq = SOLIDFRAMEFREQ;
+    solidconfig.tolerance = SOLIDTOLERANCE;
+    solidconfig.seedpoint = PixelPoint(SOLIDX, SOLIDY, *solidconfig.img.getPixel(SOLIDX, SOLIDY));
+    solidconfig.picker = &solidPicker;
+
+    animation anim;
+    anim = filler::FillScanline(solidconfig);
+    PNG result = anim.write("images/scanlinesolid.gif");
+
+    PNG expected; expected.readFromFile("soln_images/dfssolid.png");
+    REQUIRE(result==expected);
+}
+
+TEST_CASE("fill::scanline censor","[weight=1][part=fill]"){
+    PNG imgtest;
+    imgtest.readFromFile(CENSORTESTIMAGE);
+    CensorColorPicker censorPicker(CENSORWIDTH, PixelPoint(CENSORX, CENSORY, HSLAPixel()), CENSORRADIUS, imgtest);
+
+    filler::FillerConfig censorconfig;
+    censorconfig.img = imgtest;
+    censorconfig.frameFreq = CENSORFRAMEFREQ;
+    censorconfig.tolerance = CENSORTOLERANCE;
+    censorconfig.seedpoint = PixelPoint(CENSORX, CENSORY, *censorconfig.img.getPixel(CENSORX, CENSORY));
+    censorconfig.picker = &censorPicker;
+
+    animation anim;
+    anim = filler::FillScanline(censorconfig);
+    PNG result = anim.write("images/scanlinecensor.gif");
+
+    PNG expected; expected.readFromFile("soln_images/dfscensor.png");
+    REQUIRE(result==expected);
+}
+
+
+TEST_CASE("fill::seeds solid","[weight=1][part=fill]"){
+
+    HSLAPixel px(100., 1.0, 0.5);
+    SolidColorPicker solidPicker(px);
+
+    filler::FillerConfig solidconfig;
+    solidconfig.img.readFromFile(SOLIDTESTIMAGE);
+    solidconfig.frameFreq = SOLIDFRAMEFREQ;
+    solidconfig.tolerance = SOLIDTOLERANCE;
+    solidconfig.picker = &solidPicker;
+
+    vector<PixelPoint> seeds;
+    seeds.push_back(PixelPoint(SOLIDX, SOLIDY, *solidconfig.img.getPixel(SOLIDX, SOLIDY)));
+
+    animation anim;
+    anim = filler::FillSeeds(solidconfig, seeds, vector<ColorPicker*>(), 4);
+    PNG result = anim.write("images/seedssolid.gif");
+
+    PNG expected; expected.readFromFile("soln_images/dfssolid.png");
+    REQUIRE(result==expected);
+}
+
+TEST_CASE("fill::seeds overlap","[weight=1][part=fill]"){
+
+    HSLAPixel px(100., 1.0, 0.5);
+    SolidColorPicker solidPicker(px);
+    SolidColorPicker otherPicker(HSLAPixel(250., 1.0, 0.5));
+
+    PNG original;
+    original.readFromFile(SOLIDTESTIMAGE);
+
+    // the second seed lies in the same region as the first, so loses all of it
+    vector<PixelPoint> seeds;
+    seeds.push_back(PixelPoint(SOLIDX, SOLIDY, *original.getPixel(SOLIDX, SOLIDY)));
+    seeds.push_back(PixelPoint(SOLIDX + 5, SOLIDY + 5, *original.getPixel(SOLIDX, SOLIDY)));
+    vector<ColorPicker*> pickers;
+    pickers.push_back(&solidPicker);
+    pickers.push_back(&otherPicker);
+
+    PNG expected; expected.readFromFile("soln_images/dfssolid.png");
+    for (unsigned int threads = 1; threads <= 4; threads++) {
+        filler::FillerConfig solidconfig;
+        solidconfig.img = original;
+        solidconfig.frameFreq = SOLIDFRAMEFREQ;
+        solidconfig.tolerance = SOLIDTOLERANCE;
+        solidconfig.picker = &otherPicker;
+
+        animation anim;
+        anim = filler::FillSeeds(solidconfig, seeds, pickers, threads);
+        PNG result = anim.write("images/seedsoverlap.gif");
+        REQUIRE(result==expected);
+    }
+}
+
+TEST_CASE("animation::delta frames","[weight=1][part=animation]"){
+
+    PNG img;
+    img.readFromFile(SOLIDTESTIMAGE);
+    PNG first = img;
+
+    animation anim;
+    anim.addFrame(img);
+    *img.getPixel(3, 4) = HSLAPixel(10., 0.5, 0.5);
+    PNG second = img;
+    anim.addFrame(img);
+    anim.recordPixel(5, 6, HSLAPixel(20., 0.5, 0.5));
+    anim.endFrame();
+    *img.getPixel(5, 6) = HSLAPixel(20., 0.5, 0.5);
+
+    REQUIRE(anim.frameCount() == 3);
+    REQUIRE(anim.getFrame(0) == first);
+    REQUIRE(anim.getFrame(1) == second);
+    REQUIRE(anim.getFrame(2) == img);
+    // compare the changed pixel directly: PNG::operator!= prints every differing pixel
+    PNG last = anim.getFrame(2);
+    REQUIRE(*last.getPixel(5, 6) == HSLAPixel(20., 0.5, 0.5));
+    REQUIRE(*second.getPixel(5, 6) != HSLAPixel(20., 0.5, 0.5));
+}
+
+TEST_CASE("fill::streamed solid","[weight=1][part=fill]"){
+
+    HSLAPixel px(100., 1.0, 0.5);
+    SolidColorPicker solidPicker(px);
+
+    filler::FillerConfig solidconfig;
+    solidconfig.img.readFromFile(SOLIDTESTIMAGE);
+    solidconfig.frameFreq = SOLIDFRAMEFREQ;
+    solidconfig.tolerance = SOLIDTOLERANCE;
+    solidconfig.seedpoint = PixelPoint(SOLIDX, SOLIDY, *solidconfig.img.getPixel(SOLIDX, SOLIDY));
+    solidconfig.picker = &solidPicker;
+    solidconfig.streamFile = "images/dfssolidstream.gif";
+
+    animation anim;
+    anim = filler::FillDFS(solidconfig);
+    PNG result = anim.write("images/dfssolidstream.gif");
+
+    DecodedGif gif = ReadGif("images/dfssolidstream.gif");
+    REQUIRE(gif.ok);
+    REQUIRE(gif.frameRects.size() == 4 * anim.frameCount());
+    REQUIRE(GifMatches(gif, result));
+
+    PNG expected; expected.readFromFile("soln_images/dfssolid.png");
+    REQUIRE(result==expected);
+}
+
+TEST_CASE("gifwriter::frames","[weight=1][part=animation]"){
+
+    // two frames of a tiny image: the second only covers the changed pixels
+    PNG img(4, 3);
+    for (unsigned int y = 0; y < 3; y++) {
+        for (unsigned int x = 0; x < 4; x++) {
+            *img.getPixel(x, y) = HSLAPixel(90. * x, 1.0, 0.2 + 0.2 * y);
+        }
+    }
+    GifWriter writer;
+    REQUIRE(writer.Open("images/gifwriterframes.gif", 4, 3));
+    writer.SetImage(img);
+    writer.WriteFrame();
+    *img.getPixel(2, 1) = HSLAPixel(0., 0., 1.);
+    *img.getPixel(3, 2) = HSLAPixel(0., 0., 0.);
+    writer.SetImage(img);
+    writer.WriteFrame();
+    REQUIRE(writer.Close());
+
+    DecodedGif gif = ReadGif("images/gifwriterframes.gif");
+    unsigned int rects[] = { 0, 0, 4, 3, 2, 1, 2, 2 };
+    REQUIRE(gif.ok);
+    REQUIRE(gif.frameRects == vector<unsigned int>(rects, rects + 8));
+    REQUIRE(GifMatches(gif, img));
+
+    // a noisy image needs more codes than the LZW dictionary holds, so it
+    // is cleared and restarted partway through the frame
+    PNG noise(96, 96);
+    srand(221);
+    for (unsigned int y = 0; y < noise.height(); y++) {
+        for (unsigned int x = 0; x < noise.width(); x++) {
+            *noise.getPixel(x, y) = HSLAPixel(rand() % 360, 1.0, (rand() % 100) / 100.0);
+        }
+    }
+    REQUIRE(writer.Open("images/gifwriternoise.gif", noise.width(), noise.height()));
+    writer.SetImage(noise);
+    writer.WriteFrame();
+    REQUIRE(writer.Close());
+    REQUIRE(GifMatches(ReadGif("images/gifwriternoise.gif"), noise));
+}
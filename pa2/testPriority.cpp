@@ -9,6 +9,7 @@
 
 #define CATCH_CONFIG_MAIN
 #include <iostream>
+#include <stdlib.h>
 #include "cs221util/catch.hpp"
 
 #include "cs221util/HSLAPixel.h"
@@ -50,4 +51,89 @@ TEST_CASE("PriorityNeighbours::insertion_removal_isempty", "[weight=1][part=prio
     result.push_back(pn.Remove());
   }
   REQUIRE(result == expected);
-}
\ No newline at end of file
+}
+
+/*
+*  Reference ordering for the tests below: a linear scan for the minimum
+*  (distance, y, x), taking the last such point on ties, as the original
+*  vector-based collection did.
+*/
+PixelPoint RemoveByScan(vector<PixelPoint>& points, HSLAPixel ref) {
+  size_t index = 0;
+  for (size_t i = 1; i < points.size(); i++) {
+    double currDist = points[i].color.dist(ref);
+    double minDist = points[index].color.dist(ref);
+    bool better = currDist < minDist ||
+      (currDist == minDist && points[i].y < points[index].y) ||
+      (currDist == minDist && points[i].y == points[index].y && points[i].x <= points[index].x);
+    if (better) {
+      index = i;
+    }
+  }
+  PixelPoint result = points[index];
+  points.erase(points.begin() + index);
+  return result;
+}
+
+bool SamePoint(PixelPoint a, PixelPoint b) {
+  return a.x == b.x && a.y == b.y &&
+    a.color.h == b.color.h && a.color.s == b.color.s && a.color.l == b.color.l;
+}
+
+PixelPoint RandomPoint() {
+  // few distinct colours and coordinates, so that ties are common
+  return PixelPoint(rand() % 8, rand() % 8, HSLAPixel((rand() % 6) * 60, (rand() % 3) * 0.5, (rand() % 3) * 0.5));
+}
+
+TEST_CASE("PriorityNeighbours::large_sets", "[weight=1][part=priority]") {
+  srand(221);
+  HSLAPixel ref(180, 0.5, 0.5);
+  PriorityNeighbours pn(ref);
+  vector<PixelPoint> expected;
+
+  for (int i = 0; i < 2000; i++) {
+    PixelPoint p = RandomPoint();
+    pn.Insert(p);
+    expected.push_back(p);
+  }
+
+  bool same = true;
+  while (!pn.IsEmpty() && !expected.empty()) {
+    PixelPoint removed = pn.Remove();
+    same = SamePoint(removed, RemoveByScan(expected, ref)) && same;
+  }
+  REQUIRE(same);
+  REQUIRE(pn.IsEmpty());
+  REQUIRE(expected.empty());
+}
+
+TEST_CASE("PriorityNeighbours::interleaved_and_recolored", "[weight=1][part=priority]") {
+  srand(2212);
+  HSLAPixel ref(0, 1.0, 0.5);
+  PriorityNeighbours pn(ref);
+  vector<PixelPoint> expected;
+
+  bool same = true;
+  for (int round = 0; round < 50; round++) {
+    for (int i = 0; i < 40; i++) {
+      PixelPoint p = RandomPoint();
+      pn.Insert(p);
+      expected.push_back(p);
+    }
+    if (round % 5 == 0) {
+      ref = HSLAPixel((rand() % 6) * 60, 0.5, 0.5);
+      pn.SetReferenceColor(ref);
+    }
+    for (int i = 0; i < 30; i++) {
+      PixelPoint removed = pn.Remove();
+      same = SamePoint(removed, RemoveByScan(expected, ref)) && same;
+    }
+  }
+  while (!pn.IsEmpty() && !expected.empty()) {
+    PixelPoint removed = pn.Remove();
+    same = SamePoint(removed, RemoveByScan(expected, ref)) && same;
+  }
+  REQUIRE(same);
+  REQUIRE(pn.IsEmpty());
+  REQUIRE(expected.empty());
+}
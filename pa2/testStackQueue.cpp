@@ -9,10 +9,12 @@
 
 #define CATCH_CONFIG_MAIN
 #include <iostream>
+#include <string>
 #include "cs221util/catch.hpp"
 
 #include "stack.h"
 #include "queue.h"
+#include "stackqueue.h"
 
 using namespace std;
 
@@ -53,3 +55,110 @@ TEST_CASE("Queue::basic functions", "[weight=1][part=queue]") {
   REQUIRE(result == expected);
 }
 
+TEST_CASE("Queue::wraparound and growth", "[weight=1][part=queue]") {
+  Queue<int> intQueue;
+  StackQueue<int> reference;
+  vector<int> result;
+  vector<int> expected;
+  int next = 0;
+  // keep the queue partly full so the front moves around the array as it grows
+  for (int round = 0; round < 200; round++) {
+    for (int i = 0; i < 3; i++) {
+      intQueue.Add(next);
+      reference.Add(next);
+      next++;
+    }
+    for (int i = 0; i < 2; i++) {
+      REQUIRE(intQueue.Peek() == reference.Peek());
+      result.push_back(intQueue.Remove());
+      expected.push_back(reference.Remove());
+    }
+  }
+  REQUIRE(intQueue.Size() == 200);
+  REQUIRE(intQueue.Capacity() >= 200);
+  while (!intQueue.IsEmpty()) {
+    result.push_back(intQueue.Remove());
+    expected.push_back(reference.Remove());
+  }
+  REQUIRE(reference.IsEmpty());
+  REQUIRE(result == expected);
+}
+// copyable item that counts how often it is copied
+struct CountedItem {
+  static int copies;
+  string value;
+  CountedItem(const string& v) : value(v) {}
+  CountedItem(const CountedItem& other) : value(other.value) { copies++; }
+  CountedItem(CountedItem&& other) : value(std::move(other.value)) {}
+  CountedItem& operator=(const CountedItem& other) { value = other.value; copies++; return *this; }
+  CountedItem& operator=(CountedItem&& other) { value = std::move(other.value); return *this; }
+};
+int CountedItem::copies = 0;
+
+TEST_CASE("Queue::moves and emplace", "[weight=1][part=queue]") {
+  CountedItem::copies = 0;
+  {
+    Queue<CountedItem> itemQueue;
+    for (int i = 0; i < 100; i++) {
+      if (i % 2 == 0) {
+        itemQueue.Add(CountedItem(to_string(i)));
+      } else {
+        itemQueue.Emplace(to_string(i));
+      }
+    }
+    for (int i = 0; i < 100; i++) {
+      REQUIRE(itemQueue.Remove().value == to_string(i));
+    }
+    // remaining items are destroyed with the queue
+    itemQueue.Emplace("left behind");
+  }
+  REQUIRE(CountedItem::copies == 0);
+}
+
+TEST_CASE("Stack::resize policy", "[weight=1][part=stack]") {
+  Stack<int> intStack;
+  REQUIRE(intStack.Capacity() == DEFAULTCAPACITY);
+  for (int i = 0; i < 64; i++) {
+    intStack.Push(i);
+  }
+  REQUIRE(intStack.Capacity() == 64);
+  // shrinks by EXPANSIONFACTOR once fewer than 1 / SHRINKRATE of the slots are used
+  while (intStack.Size() > 15) {
+    intStack.Pop();
+  }
+  REQUIRE(intStack.Capacity() == 32);
+  intStack.Push(15);
+  REQUIRE(intStack.Capacity() == 32);
+
+  // a reserved stack keeps its capacity while it drains
+  intStack.Reserve(1000);
+  REQUIRE(intStack.Capacity() == 1000);
+  while (!intStack.IsEmpty()) {
+    intStack.Pop();
+  }
+  REQUIRE(intStack.Capacity() == 1000);
+
+  intStack.Push(7);
+  intStack.ShrinkToFit();
+  REQUIRE(intStack.Capacity() == DEFAULTCAPACITY);
+  REQUIRE(intStack.Pop() == 7);
+}
+
+TEST_CASE("Stack::non-trivial items", "[weight=1][part=stack]") {
+  CountedItem::copies = 0;
+  {
+    Stack<CountedItem> itemStack;
+    for (int i = 0; i < 100; i++) {
+      if (i % 2 == 0) {
+        itemStack.Push(CountedItem(to_string(i)));
+      } else {
+        itemStack.Emplace(to_string(i));
+      }
+    }
+    for (int i = 99; i >= 10; i--) {
+      REQUIRE(itemStack.Pop().value == to_string(i));
+    }
+    // remaining items are destroyed with the stack
+  }
+  REQUIRE(CountedItem::copies == 0);
+}
@@ -0,0 +1,137 @@
+/*
+*  File:        tolerancemask.cpp
+*  Description: Implementation of the ToleranceMask class.
+*
+*/
+
+#include "tolerancemask.h"
+#include "colorcoordinates.h"
+
+#include <algorithm>
+#include <math.h>
+#include <thread>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// pixels per bitmap word
+#define WORDPIXELS 64
+
+// fewest words given to each building thread, so small images use one thread
+#define MINTHREADWORDS 256
+
+ToleranceMask::ToleranceMask(const PNG& img, HSLAPixel color, double tolerance, unsigned int numthreads)
+  : bits(img.width(), img.height()), seedcolor(color), seedtolerance(tolerance)
+{
+  size_t numpixels = (size_t) img.width() * img.height();
+  if (numpixels == 0) {
+    return;
+  }
+  const HSLAPixel* pixels = img.getPixel(0, 0);
+  size_t words = bits.WordCount();
+
+  if (numthreads == 0) {
+    numthreads = max(thread::hardware_concurrency(), 1u);
+  }
+  numthreads = (unsigned int) min((size_t) numthreads, max(words / MINTHREADWORDS, (size_t) 1));
+
+  // each thread builds a contiguous range of whole words, so none share a word
+  size_t perthread = (words + numthreads - 1) / numthreads;
+  vector<thread> workers;
+  for (unsigned int i = 1; i < numthreads; i++) {
+    size_t first = min(i * perthread, words);
+    size_t last = min(first + perthread, words);
+    workers.push_back(thread(&ToleranceMask::computeWords, this, pixels, numpixels, first, last));
+  }
+  computeWords(pixels, numpixels, 0, min(perthread, words));
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+}
+
+ToleranceMask::ToleranceMask(ImageHandle img, HSLAPixel color, double tolerance, unsigned int numthreads)
+  : ToleranceMask(*img, color, tolerance, numthreads)
+{
+  source = img;
+}
+
+/*
+*  Computes the bitmap words [first, last). The coordinates of each word's
+*  pixels are computed first, reusing them along runs of identical pixels,
+*  and then compared with the seed's two pixels at a time.
+*/
+void ToleranceMask::computeWords(const HSLAPixel* pixels, size_t numpixels, size_t first, size_t last)
+{
+  ColorCoordinates seed = Coordinates(seedcolor);
+  double xs[WORDPIXELS], ys[WORDPIXELS], ls[WORDPIXELS];
+
+  for (size_t w = first; w < last; w++) {
+    size_t start = w * WORDPIXELS;
+    size_t count = min((size_t) WORDPIXELS, numpixels - start);
+    for (size_t i = 0; i < count; i++) {
+      HSLAPixel const& p = pixels[start + i];
+      if (i > 0 && p.h == pixels[start + i - 1].h && p.s == pixels[start + i - 1].s && p.l == pixels[start + i - 1].l) {
+        xs[i] = xs[i - 1];
+        ys[i] = ys[i - 1];
+        ls[i] = ls[i - 1];
+        continue;
+      }
+      ColorCoordinates c = Coordinates(p);
+      xs[i] = c.x;
+      ys[i] = c.y;
+      ls[i] = c.l;
+    }
+    // past the last pixel, NaN compares false so those bits stay 0
+    for (size_t i = count; i < WORDPIXELS; i++) {
+      xs[i] = ys[i] = ls[i] = NAN;
+    }
+
+    uint64_t word = 0;
+#ifdef __SSE2__
+    __m128d seedx = _mm_set1_pd(seed.x);
+    __m128d seedy = _mm_set1_pd(seed.y);
+    __m128d seedl = _mm_set1_pd(seed.l);
+    __m128d tolerance = _mm_set1_pd(seedtolerance);
+    for (int i = 0; i < WORDPIXELS; i += 2) {
+      __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), seedx);
+      __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), seedy);
+      __m128d dl = _mm_sub_pd(_mm_loadu_pd(ls + i), seedl);
+      __m128d dist = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dl, dl));
+      word |= (uint64_t) _mm_movemask_pd(_mm_cmple_pd(dist, tolerance)) << i;
+    }
+#else
+    for (int i = 0; i < WORDPIXELS; i++) {
+      double dx = xs[i] - seed.x;
+      double dy = ys[i] - seed.y;
+      double dl = ls[i] - seed.l;
+      if (dx * dx + dy * dy + dl * dl <= seedtolerance) {
+        word |= (uint64_t) 1 << i;
+      }
+    }
+#endif
+    bits.SetWord(w, word);
+  }
+}
+
+bool ToleranceMask::Matches(HSLAPixel const& color, double tolerance) const
+{
+  return color.h == seedcolor.h && color.s == seedcolor.s && color.l == seedcolor.l &&
+         color.a == seedcolor.a && tolerance == seedtolerance;
+}
+
+ImageHandle ToleranceMask::Source() const
+{
+  return source;
+}
+
+unsigned int ToleranceMask::Width() const
+{
+  return bits.Width();
+}
+
+unsigned int ToleranceMask::Height() const
+{
+  return bits.Height();
+}
@@ -0,0 +1,83 @@
+/*
+*  File:        tolerancemask.h
+*  Description: Definition of a ToleranceMask class, a precomputed bitmap of
+*               the pixels of an image within a tolerance of a colour.
+*
+*/
+
+#ifndef _TOLERANCEMASK_H_
+#define _TOLERANCEMASK_H_
+
+#include "cs221util/HSLAPixel.h"
+#include "cs221util/PNG.h"
+
+#include "imagehandle.h"
+#include "pixelbitmap.h"
+
+using namespace cs221util;
+
+/*
+*  ToleranceMask answers "is pixel (x, y) within tolerance of the seed
+*  colour?" with a bit lookup. The bits are computed once, in parallel, when
+*  the mask is built, so a fill does not compute a colour distance each time
+*  it examines a pixel. The mask agrees exactly with HSLAPixel::dist.
+*
+*  A mask describes the image as it was when the mask was built. A mask
+*  built from an ImageHandle remembers the handle, and can be reused by any
+*  number of fills of copies of that image with the same seed colour and
+*  tolerance (see FillerConfig::mask and FillerConfig::source).
+*/
+class ToleranceMask {
+  public:
+    /*
+    *  Builds the mask of the pixels p of img with p.dist(color) <= tolerance.
+    *  PARAM: img - image to test
+    *  PARAM: color - colour to measure distances from
+    *  PARAM: tolerance - greatest distance counted as in tolerance
+    *  PARAM: numthreads - number of threads to build with, or 0 for one per
+    *                      hardware thread
+    */
+    ToleranceMask(const PNG& img, HSLAPixel color, double tolerance, unsigned int numthreads = 0);
+
+    /*
+    *  Builds the mask of the shared image img, as above, and remembers img
+    *  as the mask's source.
+    *  PRE: *img does not change while the mask is in use.
+    */
+    ToleranceMask(ImageHandle img, HSLAPixel color, double tolerance, unsigned int numthreads = 0);
+
+    /*
+    *  Returns true if pixel (x, y) is within tolerance.
+    *  PRE: (x, y) lies within the image.
+    */
+    bool Get(unsigned int x, unsigned int y) const {
+      return bits.Get(x, y);
+    }
+
+    /*
+    *  Returns true if the mask was built for exactly this colour and tolerance.
+    */
+    bool Matches(HSLAPixel const& color, double tolerance) const;
+
+    /*
+    *  Returns the image the mask was built from, or null if it was built
+    *  from a PNG rather than an ImageHandle.
+    */
+    ImageHandle Source() const;
+
+    /*
+    *  Returns the dimensions of the mask.
+    */
+    unsigned int Width() const;
+    unsigned int Height() const;
+
+  private:
+    PixelBitmap bits;         // bit set for each pixel within tolerance
+    HSLAPixel seedcolor;      // colour distances were measured from
+    double seedtolerance;     // greatest distance counted as in tolerance
+    ImageHandle source;       // image the mask was built from, if shared
+
+    void computeWords(const HSLAPixel* pixels, size_t numpixels, size_t first, size_t last);
+};
+
+#endif